@@ -0,0 +1,827 @@
+/*
+ * benchmark.c
+ *
+ * Measures how the standings queries scale with the number of drivers, and
+ * compares the standings backends.
+ * Build with -DCMAKE_BUILD_TYPE=Release to get meaningful numbers.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdbool.h>
+#include "season.h"
+#include "scanner.h"
+#include "points.h"
+#include "simulator.h"
+
+#define BENCHMARK_RACES 5
+#define BENCHMARK_REPETITIONS 5
+#define BENCHMARK_BACKFILL_RACES 1000
+#define BENCHMARK_SCANNER_DRIVERS 12000000
+#define BENCHMARK_PARSER_DRIVERS 1000000
+#define BENCHMARK_SCANNER_BATCH 256
+#define BENCHMARK_KERNEL_WORK 20000000 // Drivers updated per measurement.
+#define BENCHMARK_CLONE_RACES 20
+#define BENCHMARK_SIMULATED_RACES 10
+#define BENCHMARK_SIMULATIONS 200000
+#define BENCHMARK_FUTURES 1024
+#define BENCHMARK_SMALL_RACES 200000
+#define BENCHMARK_SMALL_RESULTS 1024 // Distinct races, played in turn.
+
+/** Declarations */
+static char* CreateSeasonInfo(int number_of_drivers);
+static void ShuffleResults(int* results, int number_of_drivers,
+                           unsigned int* seed);
+static double NowInSeconds(void);
+static void BenchmarkDriversStandings(int number_of_drivers);
+static double TimeRaces(Season season, StandingsBackend backend,
+                        int* results, int number_of_drivers);
+static void BenchmarkStandingsBackends(int number_of_drivers);
+static void BenchmarkSmallRoster(int number_of_drivers);
+static double TimeSmallRaces(Season season, StandingsBackend backend,
+                             const int* results, int number_of_drivers);
+static void BenchmarkBackfill(int number_of_drivers);
+static void BenchmarkScanner(void);
+static double TimeScan(ScannerBackend backend, const char* data,
+                       size_t length, size_t* lines);
+static void BenchmarkParser(void);
+static void BenchmarkPointsKernel(int number_of_drivers);
+static void BenchmarkConcurrentReads(int number_of_drivers);
+static void BenchmarkClone(int number_of_drivers);
+static void BenchmarkSimulator(int number_of_drivers, int threads);
+static void BenchmarkFuturesKernels(int number_of_drivers);
+static double TimeFuturesKernel(PointsBackend backend, bool rank,
+                                int* points, const int* positions,
+                                int* ranks, int number_of_drivers);
+static void RankFutureWithQsort(const int* points, const int* positions,
+                                int number_of_drivers, int future,
+                                int (*keys)[3], int* ranks);
+static int CompareFutureKeys(const void* first, const void* second);
+/** End of declarations */
+
+int main(void){
+    printf("%10s %10s %14s %10s %20s\n", "drivers", "race[ms]",
+           "standings[ms]", "teams[ms]", "race ns/(n*log2(n))");
+    for (int drivers=1000;drivers<=512000;drivers*=2){
+        BenchmarkDriversStandings(drivers);
+    }
+    printf("\n%10s %16s %16s %10s\n", "drivers", "comparison[ms]",
+           "radix[ms]", "speedup");
+    BenchmarkStandingsBackends(1000);
+    BenchmarkStandingsBackends(100000);
+    BenchmarkStandingsBackends(1000000);
+    printf("\n%10s %16s %16s %16s\n", "drivers", "comparison[ns]",
+           "radix[ns]", "network[ns]");
+    BenchmarkSmallRoster(8);
+    BenchmarkSmallRoster(20);
+    BenchmarkSmallRoster(32);
+    printf("\n%10s %10s %16s %16s %10s\n", "drivers", "races",
+           "one by one[ms]", "batch[ms]", "speedup");
+    BenchmarkBackfill(20);
+    BenchmarkBackfill(1000);
+    BenchmarkScanner();
+    BenchmarkParser();
+    printf("\n%10s %16s %16s %16s\n", "drivers", "scalar[races/s]",
+           "avx2[races/s]", "avx512[races/s]");
+    BenchmarkPointsKernel(20);
+    BenchmarkPointsKernel(1000);
+    BenchmarkPointsKernel(100000);
+    BenchmarkPointsKernel(1000000);
+    printf("\n%10s %16s %16s %16s\n", "drivers", "race[ms]",
+           "published[ms]", "pin+query[ns]");
+    BenchmarkConcurrentReads(20);
+    BenchmarkConcurrentReads(1000);
+    BenchmarkConcurrentReads(100000);
+    printf("\n%10s %10s %16s %16s %10s\n", "drivers", "races",
+           "rebuild[ms]", "clone[ms]", "speedup");
+    BenchmarkClone(20);
+    BenchmarkClone(1000);
+    BenchmarkClone(100000);
+    printf("\n%10s %10s %10s %16s\n", "drivers", "races", "threads",
+           "seasons/s");
+    BenchmarkSimulator(20, 1);
+    BenchmarkSimulator(20, 2);
+    BenchmarkSimulator(20, 4);
+    BenchmarkSimulator(1000, 1);
+    printf("\n%10s %8s %16s %16s %16s %16s\n", "drivers", "kernel",
+           "per future[M/s]", "scalar[M/s]", "avx2[M/s]", "avx512[M/s]");
+    BenchmarkFuturesKernels(20);
+    BenchmarkFuturesKernels(30);
+    return 0;
+}
+
+/** Static functions */
+/**
+ ***** Static function: CreateSeasonInfo *****
+ * Description: creates a season info string with the given number of
+ * drivers, two drivers per team.
+ * @param number_of_drivers - Number of drivers in the season.
+ * @return - A new string (the caller has to free it) or NULL.
+ */
+static char* CreateSeasonInfo(int number_of_drivers){
+    size_t size = 8 + (size_t)number_of_drivers*48;
+    char* season_info = malloc(size);
+    if (season_info==NULL){
+        return NULL;
+    }
+    size_t length = (size_t)sprintf(season_info, "2018\n");
+    for (int i=0;i<number_of_drivers;i++){
+        if (i%2 == 0){
+            length += (size_t)sprintf(season_info+length, "Team %d\n", i/2);
+        }
+        length += (size_t)sprintf(season_info+length, "Driver %d\n", i);
+    }
+    if (number_of_drivers%2 == 1){
+        length += (size_t)sprintf(season_info+length, "None\n");
+    }
+    return season_info;
+}
+
+/**
+ ***** Static function: ShuffleResults *****
+ * Description: fills 'results' with a random permutation of the ids.
+ * @param results - An array of size number_of_drivers.
+ * @param number_of_drivers - Number of drivers.
+ * @param seed - Seed of the generator, updated by the function.
+ */
+static void ShuffleResults(int* results, int number_of_drivers,
+                           unsigned int* seed){
+    for (int i=0;i<number_of_drivers;i++){
+        results[i] = i+1;
+    }
+    for (int i=number_of_drivers-1;i>0;i--){
+        *seed = *seed*1103515245u + 12345u;
+        int j = (int)((*seed>>8)%(unsigned int)(i+1));
+        int temp = results[i];
+        results[i] = results[j];
+        results[j] = temp;
+    }
+}
+
+/**
+ ***** Static function: NowInSeconds *****
+ * @return - A monotonic time stamp in seconds.
+ */
+static double NowInSeconds(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+}
+
+/**
+ ***** Static function: BenchmarkDriversStandings *****
+ * Description: creates a season, adds a few races with many ties and
+ * prints the best time of SeasonAddRaceResult (which ranks the drivers),
+ * of SeasonGetDriversStandings and of the first SeasonGetTeamsStandings
+ * after a race (which sorts the teams).
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkDriversStandings(int number_of_drivers){
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers);
+    Season season = SeasonCreate(NULL, season_info);
+    if (season_info==NULL || results==NULL || season==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+        free(season_info);
+        free(results);
+        SeasonDestroy(season);
+        return;
+    }
+    unsigned int seed = 2018;
+    double best_race = -1, best_teams = -1;
+    for (int race=0;race<BENCHMARK_RACES;race++){
+        ShuffleResults(results, number_of_drivers, &seed);
+        double start = NowInSeconds();
+        SeasonAddRaceResult(season, results);
+        double elapsed = NowInSeconds()-start;
+        if (best_race<0 || elapsed<best_race){
+            best_race = elapsed;
+        }
+        start = NowInSeconds();
+        Team* teams_standings = SeasonGetTeamsStandings(season);
+        elapsed = NowInSeconds()-start;
+        free(teams_standings);
+        if (best_teams<0 || elapsed<best_teams){
+            best_teams = elapsed;
+        }
+    }
+    double best = -1;
+    for (int i=0;i<BENCHMARK_REPETITIONS;i++){
+        double start = NowInSeconds();
+        Driver* standings = SeasonGetDriversStandings(season);
+        double elapsed = NowInSeconds()-start;
+        free(standings);
+        if (best<0 || elapsed<best){
+            best = elapsed;
+        }
+    }
+    printf("%10d %10.3f %14.3f %10.3f %20.3f\n", number_of_drivers,
+           best_race*1e3, best*1e3, best_teams*1e3,
+           best_race*1e9/(number_of_drivers*log2(number_of_drivers)));
+    SeasonDestroy(season);
+    free(results);
+    free(season_info);
+}
+
+/**
+ ***** Static function: TimeRaces *****
+ * Description: adds BENCHMARK_RACES random races to the season using the
+ * given standings backend.
+ * @param season - A pointer to a season.
+ * @param backend - The standings backend to use.
+ * @param results - A buffer for the results of a race.
+ * @param number_of_drivers - Number of drivers in the season.
+ * @return - The best time of a single SeasonAddRaceResult.
+ */
+static double TimeRaces(Season season, StandingsBackend backend,
+                        int* results, int number_of_drivers){
+    unsigned int seed = 2018;
+    double best = -1;
+    SeasonSetStandingsBackend(season, backend);
+    for (int race=0;race<BENCHMARK_RACES;race++){
+        ShuffleResults(results, number_of_drivers, &seed);
+        double start = NowInSeconds();
+        SeasonAddRaceResult(season, results);
+        double elapsed = NowInSeconds()-start;
+        if (best<0 || elapsed<best){
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/**
+ ***** Static function: BenchmarkStandingsBackends *****
+ * Description: prints the race time of the comparison backend against the
+ * radix backend. Each backend gets its own season fed the same races.
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkStandingsBackends(int number_of_drivers){
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers);
+    Season comparison = SeasonCreate(NULL, season_info);
+    Season radix = SeasonCreate(NULL, season_info);
+    if (season_info==NULL || results==NULL || comparison==NULL ||
+        radix==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+    }
+    else {
+        double comparison_time = TimeRaces(comparison,
+                STANDINGS_BACKEND_COMPARISON, results, number_of_drivers);
+        double radix_time = TimeRaces(radix, STANDINGS_BACKEND_RADIX,
+                                      results, number_of_drivers);
+        printf("%10d %16.3f %16.3f %9.1fx\n", number_of_drivers,
+               comparison_time*1e3, radix_time*1e3,
+               comparison_time/radix_time);
+    }
+    SeasonDestroy(comparison);
+    SeasonDestroy(radix);
+    free(results);
+    free(season_info);
+}
+
+/**
+ ***** Static function: BenchmarkSmallRoster *****
+ * Description: prints the time of a race followed by a teams standings
+ * query, which sorts the drivers and the teams, for each standings backend
+ * of a small season.
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkSmallRoster(int number_of_drivers){
+    const StandingsBackend backends[] = {STANDINGS_BACKEND_COMPARISON,
+                                         STANDINGS_BACKEND_RADIX,
+                                         STANDINGS_BACKEND_NETWORK};
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers*
+                          BENCHMARK_SMALL_RESULTS);
+    if (season_info==NULL || results==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+        free(results);
+        free(season_info);
+        return;
+    }
+    unsigned int seed = 2018;
+    for (int race=0;race<BENCHMARK_SMALL_RESULTS;race++){
+        ShuffleResults(results+(size_t)race*number_of_drivers,
+                       number_of_drivers, &seed);
+    }
+    printf("%10d", number_of_drivers);
+    for (int i=0;i<3;i++){
+        Season season = SeasonCreate(NULL, season_info);
+        if (season==NULL){
+            printf(" %16s", "failed");
+            continue;
+        }
+        printf(" %16.1f", TimeSmallRaces(season, backends[i], results,
+                                         number_of_drivers)*1e9);
+        SeasonDestroy(season);
+    }
+    printf("\n");
+    free(results);
+    free(season_info);
+}
+
+/**
+ ***** Static function: TimeSmallRaces *****
+ * Description: plays BENCHMARK_SMALL_RACES races in a season, querying the
+ * teams standings after each one.
+ * @param season - The season to feed.
+ * @param backend - The standings backend to use.
+ * @param results - BENCHMARK_SMALL_RESULTS races, played in turn.
+ * @param number_of_drivers - Number of drivers in the season.
+ * @return - The mean time of a race and its query, in seconds.
+ */
+static double TimeSmallRaces(Season season, StandingsBackend backend,
+                             const int* results, int number_of_drivers){
+    SeasonSetStandingsBackend(season, backend);
+    volatile Team leader = NULL;
+    double start = NowInSeconds();
+    for (int race=0;race<BENCHMARK_SMALL_RACES;race++){
+        SeasonAddRaceResult(season, (int*)results+
+                (size_t)(race%BENCHMARK_SMALL_RESULTS)*number_of_drivers);
+        leader = SeasonGetTeamByPosition(season, 1, NULL);
+    }
+    (void)leader;
+    return (NowInSeconds()-start)/BENCHMARK_SMALL_RACES;
+}
+
+/**
+ ***** Static function: BenchmarkBackfill *****
+ * Description: prints the time of adding BENCHMARK_BACKFILL_RACES random
+ * races one by one against adding them in a single SeasonAddRaceResults.
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkBackfill(int number_of_drivers){
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers*
+                          BENCHMARK_BACKFILL_RACES);
+    Season one_by_one = SeasonCreate(NULL, season_info);
+    Season batch = SeasonCreate(NULL, season_info);
+    if (season_info==NULL || results==NULL || one_by_one==NULL ||
+        batch==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+    }
+    else {
+        unsigned int seed = 2018;
+        for (int race=0;race<BENCHMARK_BACKFILL_RACES;race++){
+            ShuffleResults(results+(size_t)race*number_of_drivers,
+                           number_of_drivers, &seed);
+        }
+        double start = NowInSeconds();
+        for (int race=0;race<BENCHMARK_BACKFILL_RACES;race++){
+            SeasonAddRaceResult(one_by_one,
+                                results+(size_t)race*number_of_drivers);
+        }
+        double one_by_one_time = NowInSeconds()-start;
+        start = NowInSeconds();
+        SeasonAddRaceResults(batch, results, BENCHMARK_BACKFILL_RACES);
+        double batch_time = NowInSeconds()-start;
+        printf("%10d %10d %16.3f %16.3f %9.1fx\n", number_of_drivers,
+               BENCHMARK_BACKFILL_RACES, one_by_one_time*1e3,
+               batch_time*1e3, one_by_one_time/batch_time);
+    }
+    SeasonDestroy(one_by_one);
+    SeasonDestroy(batch);
+    free(results);
+    free(season_info);
+}
+
+/**
+ ***** Static function: BenchmarkScanner *****
+ * Description: prints the throughput of each supported scanner backend on a
+ * synthetic roster of a few hundred MB. The scalar backend is the memchr
+ * loop the roster parser used before the vector backends.
+ */
+static void BenchmarkScanner(void){
+    char* season_info = CreateSeasonInfo(BENCHMARK_SCANNER_DRIVERS);
+    if (season_info==NULL){
+        fprintf(stderr, "allocation failed for the scanner benchmark\n");
+        return;
+    }
+    size_t length = strlen(season_info);
+    const char* names[] = {"scalar", "sse2", "avx2"};
+    ScannerBackend backends[] = {SCANNER_BACKEND_SCALAR, SCANNER_BACKEND_SSE2,
+                                 SCANNER_BACKEND_AVX2};
+    printf("\n%10s %10s %12s %12s\n", "scanner", "MB", "lines", "MB/s");
+    for (int i=0;i<3;i++){
+        if (!ScannerBackendIsSupported(backends[i])){
+            printf("%10s %10s\n", names[i], "unsupported");
+            continue;
+        }
+        size_t lines = 0;
+        double best = TimeScan(backends[i], season_info, length, &lines);
+        printf("%10s %10.1f %12zu %12.1f\n", names[i], length/1e6, lines,
+               length/1e6/best);
+    }
+    free(season_info);
+}
+
+/**
+ ***** Static function: TimeScan *****
+ * Description: finds all the newlines of a buffer, a batch at a time.
+ * @param backend - The scanner backend.
+ * @param data - The buffer.
+ * @param length - Length of the buffer.
+ * @param lines - Gets the number of newlines.
+ * @return - The best time of BENCHMARK_REPETITIONS scans.
+ */
+static double TimeScan(ScannerBackend backend, const char* data,
+                       size_t length, size_t* lines){
+    size_t newlines[BENCHMARK_SCANNER_BATCH];
+    double best = -1;
+    for (int repetition=0;repetition<BENCHMARK_REPETITIONS;repetition++){
+        double start = NowInSeconds();
+        size_t scanned = 0, found, count = 0;
+        do {
+            found = ScannerFindNewlines(backend, data+scanned,
+                                        length-scanned, newlines,
+                                        BENCHMARK_SCANNER_BATCH);
+            count += found;
+            if (found>0){
+                scanned += newlines[found-1]+1;
+            }
+        } while (found==BENCHMARK_SCANNER_BATCH);
+        double elapsed = NowInSeconds()-start;
+        if (best<0 || elapsed<best){
+            best = elapsed;
+        }
+        *lines = count;
+    }
+    return best;
+}
+
+/**
+ ***** Static function: BenchmarkParser *****
+ * Description: prints the best time and throughput of SeasonCreate, which
+ * scans the lines with the best backend and creates the teams and drivers,
+ * and the best time of SeasonDestroy.
+ */
+static void BenchmarkParser(void){
+    char* season_info = CreateSeasonInfo(BENCHMARK_PARSER_DRIVERS);
+    if (season_info==NULL){
+        fprintf(stderr, "allocation failed for the parser benchmark\n");
+        return;
+    }
+    size_t length = strlen(season_info);
+    double best_create = -1, best_destroy = -1;
+    for (int repetition=0;repetition<BENCHMARK_REPETITIONS;repetition++){
+        double start = NowInSeconds();
+        Season season = SeasonCreate(NULL, season_info);
+        double created = NowInSeconds();
+        SeasonDestroy(season);
+        double destroyed = NowInSeconds();
+        if (best_create<0 || created-start<best_create){
+            best_create = created-start;
+        }
+        if (best_destroy<0 || destroyed-created<best_destroy){
+            best_destroy = destroyed-created;
+        }
+    }
+    printf("\n%10s %10s %12s %12s %12s\n", "parser", "MB", "create[ms]",
+           "MB/s", "destroy[ms]");
+    printf("%10d %10.1f %12.3f %12.1f %12.3f\n", BENCHMARK_PARSER_DRIVERS,
+           length/1e6, best_create*1e3, length/1e6/best_create,
+           best_destroy*1e3);
+    free(season_info);
+}
+
+/**
+ ***** Static function: BenchmarkPointsKernel *****
+ * Description: prints how many races per second each supported points
+ * backend adds to a points array (0 for an unsupported backend).
+ * @param number_of_drivers - Number of drivers in a race.
+ */
+static void BenchmarkPointsKernel(int number_of_drivers){
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers);
+    int* points = calloc((size_t)number_of_drivers, sizeof(*points));
+    if (results==NULL || points==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+        free(results);
+        free(points);
+        return;
+    }
+    unsigned int seed = 2018;
+    ShuffleResults(results, number_of_drivers, &seed);
+    PointsBackend backends[] = {POINTS_BACKEND_SCALAR, POINTS_BACKEND_AVX2,
+                                POINTS_BACKEND_AVX512};
+    int races = BENCHMARK_KERNEL_WORK/number_of_drivers;
+    printf("%10d", number_of_drivers);
+    for (int b=0;b<3;b++){
+        double best = -1;
+        for (int repetition=0;repetition<BENCHMARK_REPETITIONS &&
+                              PointsBackendIsSupported(backends[b]);
+             repetition++){
+            double start = NowInSeconds();
+            for (int race=0;race<races;race++){
+                PointsAddRace(backends[b], points, results,
+                              number_of_drivers);
+            }
+            double elapsed = NowInSeconds()-start;
+            if (best<0 || elapsed<best){
+                best = elapsed;
+            }
+        }
+        printf(" %16.0f", (best>0) ? races/best : 0.0);
+    }
+    printf("\n");
+    free(results);
+    free(points);
+}
+
+/**
+ ***** Static function: BenchmarkConcurrentReads *****
+ * Description: prints the time of a race without and with concurrent
+ * reads, whose standings publication the writer pays for, and the time of
+ * pinning the standings and querying the leader.
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkConcurrentReads(int number_of_drivers){
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers);
+    Season season = SeasonCreate(NULL, season_info);
+    if (season_info==NULL || results==NULL || season==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+        free(results);
+        free(season_info);
+        SeasonDestroy(season);
+        return;
+    }
+    unsigned int seed = 2018;
+    ShuffleResults(results, number_of_drivers, &seed);
+    int races = 1+BENCHMARK_KERNEL_WORK/100/number_of_drivers;
+    double times[2];
+    for (int published=0;published<2;published++){
+        if (published){
+            SeasonEnableConcurrentReads(season, 1);
+        }
+        double start = NowInSeconds();
+        for (int race=0;race<races;race++){
+            SeasonAddRaceResult(season, results);
+        }
+        times[published] = (NowInSeconds()-start)/races;
+    }
+    SeasonReader reader = SeasonReaderCreate(season, NULL);
+    int reads = 1000000;
+    volatile int leader_points = 0; // Keeps the queries from being dropped.
+    double start = NowInSeconds();
+    for (int read=0;read<reads;read++){
+        int points = 0;
+        SeasonStandingsGetDriverByPosition(SeasonReaderBegin(reader), 1,
+                                           &points);
+        leader_points = points;
+        SeasonReaderEnd(reader);
+    }
+    (void)leader_points;
+    double read_time = (NowInSeconds()-start)/reads;
+    printf("%10d %16.3f %16.3f %16.1f\n", number_of_drivers, times[0]*1e3,
+           times[1]*1e3, read_time*1e9);
+    SeasonReaderDestroy(reader);
+    SeasonDestroy(season);
+    free(results);
+    free(season_info);
+}
+
+/**
+ ***** Static function: BenchmarkClone *****
+ * Description: prints the time of branching a season after
+ * BENCHMARK_CLONE_RACES races: rebuilding it from the season info and
+ * replaying the races, against SeasonClone.
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkClone(int number_of_drivers){
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    int* results = malloc(sizeof(*results)*(size_t)number_of_drivers*
+                          BENCHMARK_CLONE_RACES);
+    Season season = SeasonCreate(NULL, season_info);
+    if (season_info==NULL || results==NULL || season==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+        free(results);
+        free(season_info);
+        SeasonDestroy(season);
+        return;
+    }
+    unsigned int seed = 2018;
+    for (int race=0;race<BENCHMARK_CLONE_RACES;race++){
+        ShuffleResults(results+(size_t)race*number_of_drivers,
+                       number_of_drivers, &seed);
+    }
+    SeasonAddRaceResults(season, results, BENCHMARK_CLONE_RACES);
+    double rebuild_time = -1, clone_time = -1;
+    for (int repetition=0;repetition<BENCHMARK_REPETITIONS;repetition++){
+        double start = NowInSeconds();
+        Season rebuilt = SeasonCreate(NULL, season_info);
+        SeasonAddRaceResults(rebuilt, results, BENCHMARK_CLONE_RACES);
+        double elapsed = NowInSeconds()-start;
+        SeasonDestroy(rebuilt);
+        if (rebuild_time<0 || elapsed<rebuild_time){
+            rebuild_time = elapsed;
+        }
+        start = NowInSeconds();
+        Season clone = SeasonClone(season, NULL);
+        elapsed = NowInSeconds()-start;
+        SeasonDestroy(clone);
+        if (clone_time<0 || elapsed<clone_time){
+            clone_time = elapsed;
+        }
+    }
+    printf("%10d %10d %16.3f %16.3f %9.1fx\n", number_of_drivers,
+           BENCHMARK_CLONE_RACES, rebuild_time*1e3, clone_time*1e3,
+           rebuild_time/clone_time);
+    SeasonDestroy(season);
+    free(results);
+    free(season_info);
+}
+
+/**
+ ***** Static function: BenchmarkSimulator *****
+ * Description: prints how many seasons of BENCHMARK_SIMULATED_RACES races
+ * the simulator plays per second.
+ * @param number_of_drivers - Number of drivers in the season.
+ * @param threads - Number of threads to simulate with.
+ */
+static void BenchmarkSimulator(int number_of_drivers, int threads){
+    char* season_info = CreateSeasonInfo(number_of_drivers);
+    Season season = SeasonCreate(NULL, season_info);
+    Simulator simulator = SimulatorCreate(season, NULL);
+    if (season_info==NULL || season==NULL || simulator==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+    }
+    else {
+        long long simulations = BENCHMARK_SIMULATIONS*20LL/number_of_drivers;
+        double start = NowInSeconds();
+        SimulatorRun(simulator, BENCHMARK_SIMULATED_RACES, simulations,
+                     threads, 2018);
+        double elapsed = NowInSeconds()-start;
+        printf("%10d %10d %10d %16.0f\n", number_of_drivers,
+               BENCHMARK_SIMULATED_RACES, threads, simulations/elapsed);
+    }
+    SimulatorDestroy(simulator);
+    SeasonDestroy(season);
+    free(season_info);
+}
+
+/**
+ ***** Static function: BenchmarkFuturesKernels *****
+ * Description: prints how many futures per second get a race scored, and
+ * get ranked, with BENCHMARK_FUTURES interleaved futures. "per future" is
+ * the scalar points kernel called for one future at a time for the race,
+ * and a qsort of each future's standings for the ranking.
+ * @param number_of_drivers - Number of drivers in the season.
+ */
+static void BenchmarkFuturesKernels(int number_of_drivers){
+    size_t size = (size_t)number_of_drivers*BENCHMARK_FUTURES;
+    int* points = calloc(size, sizeof(*points));
+    int* positions = malloc(sizeof(*positions)*size);
+    int* ranks = malloc(sizeof(*ranks)*size);
+    int* results = malloc(sizeof(*results)*size);
+    int (*keys)[3] = malloc(sizeof(*keys)*(size_t)number_of_drivers);
+    if (points==NULL || positions==NULL || ranks==NULL || results==NULL ||
+        keys==NULL){
+        fprintf(stderr, "allocation failed for %d drivers\n",
+                number_of_drivers);
+    }
+    else {
+        /* results holds the races of the futures one after the other, and
+         * positions the same races interleaved. */
+        unsigned int seed = 2018;
+        for (int f=0;f<BENCHMARK_FUTURES;f++){
+            int* race = results+(size_t)f*number_of_drivers;
+            ShuffleResults(race, number_of_drivers, &seed);
+            for (int p=0;p<number_of_drivers;p++){
+                positions[(size_t)(race[p]-1)*BENCHMARK_FUTURES+f] = p+1;
+            }
+        }
+        PointsBackend backends[] = {POINTS_BACKEND_SCALAR,
+                                    POINTS_BACKEND_AVX2,
+                                    POINTS_BACKEND_AVX512};
+        for (int rank=0;rank<2;rank++){
+            double best = -1;
+            for (int repetition=0;repetition<BENCHMARK_REPETITIONS;
+                 repetition++){
+                double start = NowInSeconds();
+                for (int f=0;f<BENCHMARK_FUTURES;f++){
+                    if (rank){
+                        RankFutureWithQsort(points, positions,
+                                            number_of_drivers, f, keys,
+                                            ranks);
+                    }
+                    else {
+                        PointsAddRace(POINTS_BACKEND_SCALAR,
+                                      points+(size_t)f*number_of_drivers,
+                                      results+(size_t)f*number_of_drivers,
+                                      number_of_drivers);
+                    }
+                }
+                double elapsed = NowInSeconds()-start;
+                if (best<0 || elapsed<best){
+                    best = elapsed;
+                }
+            }
+            printf("%10d %8s %16.1f", number_of_drivers,
+                   rank ? "rank" : "race", BENCHMARK_FUTURES/best/1e6);
+            for (int b=0;b<3;b++){
+                double time = PointsBackendIsSupported(backends[b]) ?
+                        TimeFuturesKernel(backends[b], rank, points,
+                                          positions, ranks,
+                                          number_of_drivers) : 0;
+                printf(" %16.1f", (time>0) ? BENCHMARK_FUTURES/time/1e6 : 0);
+            }
+            printf("\n");
+        }
+    }
+    free(points);
+    free(positions);
+    free(ranks);
+    free(results);
+    free(keys);
+}
+
+/**
+ ***** Static function: TimeFuturesKernel *****
+ * Description: times a kernel on BENCHMARK_FUTURES interleaved futures.
+ * @param backend - The backend of the kernel.
+ * @param rank - True for the ranking kernel, false for the race kernel.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved positions.
+ * @param ranks - Room for the interleaved ranks.
+ * @param number_of_drivers - Number of drivers.
+ * @return - The best time of BENCHMARK_REPETITIONS runs, in seconds.
+ */
+static double TimeFuturesKernel(PointsBackend backend, bool rank,
+                                int* points, const int* positions,
+                                int* ranks, int number_of_drivers){
+    double best = -1;
+    for (int repetition=0;repetition<BENCHMARK_REPETITIONS;repetition++){
+        double start = NowInSeconds();
+        if (rank){
+            PointsRankFutures(backend, points, positions, number_of_drivers,
+                              BENCHMARK_FUTURES, ranks);
+        }
+        else {
+            PointsAddRaceFutures(backend, points, positions,
+                                 number_of_drivers, BENCHMARK_FUTURES);
+        }
+        double elapsed = NowInSeconds()-start;
+        if (best<0 || elapsed<best){
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/**
+ ***** Static function: RankFutureWithQsort *****
+ * Description: ranks the drivers of one of the interleaved futures by
+ * sorting its standings keys, the way a single season is ranked.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved positions.
+ * @param number_of_drivers - Number of drivers.
+ * @param future - The future to rank.
+ * @param keys - Room for a key per driver.
+ * @param ranks - Will hold the ranks of the future, interleaved.
+ */
+static void RankFutureWithQsort(const int* points, const int* positions,
+                                int number_of_drivers, int future,
+                                int (*keys)[3], int* ranks){
+    for (int i=0;i<number_of_drivers;i++){
+        size_t at = (size_t)i*BENCHMARK_FUTURES+future;
+        keys[i][0] = points[at];
+        keys[i][1] = positions[at];
+        keys[i][2] = i;
+    }
+    qsort(keys, (size_t)number_of_drivers, sizeof(*keys), CompareFutureKeys);
+    for (int p=0;p<number_of_drivers;p++){
+        ranks[(size_t)keys[p][2]*BENCHMARK_FUTURES+future] = p+1;
+    }
+}
+
+/**
+ ***** Static function: CompareFutureKeys *****
+ * Description: qsort comparator of (points, position, index) keys, in the
+ * order of the standings.
+ */
+static int CompareFutureKeys(const void* first, const void* second){
+    const int* first_key = first;
+    const int* second_key = second;
+    if (first_key[0]!=second_key[0]){
+        return (first_key[0]>second_key[0]) ? -1 : 1;
+    }
+    if (first_key[1]!=second_key[1]){
+        return (first_key[1]<second_key[1]) ? -1 : 1;
+    }
+    return (first_key[2]<second_key[2]) ? -1 : 1;
+}
+/** End of static functions */
@@ -2,20 +2,27 @@
 #include <malloc.h>
 #include <string.h>
 #include <assert.h>
+#include <stdbool.h>
 #include "driver.h"
+#include "season_internal.h"
 
 #define MIN_POSITION 1
 
 /** Declarations */
 static Season DriverGetSeason(Driver driver);
+static void DriverPointsChanged(Driver driver, int change);
 /** End of decalarations */
 
 struct driver {
     int id;
     char* driver_name;
     Team team;
-    int points;
+    /* Points to own_points, or into the points array of the driver's
+     * season, which keeps the points of all its drivers together. */
+    int* points;
+    int own_points;
     Season season_of_driver;
+    bool owns_name; // False if the name belongs to someone else.
 };
 
 /**
@@ -42,27 +49,74 @@ Driver DriverCreate(DriverStatus* status, char* driver_name, int driverId){
         return NULL;
     }
     strcpy(name,driver_name);
+    Driver driver = DriverCreateNoCopy(status,name,driverId);
+    if (driver==NULL){
+        free(name);
+        return NULL;
+    }
+    driver->owns_name = true;
+    return driver;
+}
+
+/**
+ ***** Function: DriverCreateNoCopy *****
+ * Creates a new driver which uses the given name without copying it.
+ * Used by the season, which keeps all the names in one buffer.
+ * @param status - will hold success or fail of the function.
+ * @param driver_name - A string which contains the driver's name. It must
+ * outlive the driver and is not freed by DriverDestroy.
+ * @param driverId - A given id.
+ * @return return - NULL in case of failure or pointer to the created
+ * driver in case of success.
+ */
+Driver DriverCreateNoCopy(DriverStatus* status, char* driver_name,
+                          int driverId){
+    if (driver_name==NULL || driverId<=0){ // Checks if id is vaild.
+        if (status!=NULL){
+            *status=INVALID_DRIVER;
+        }
+        return NULL;
+    }
     Driver driver = malloc(sizeof(*driver));
     if (driver==NULL){ // Checks if memory allocation failed.
         if (status!=NULL){
             *status=DRIVER_MEMORY_ERROR;
         }
-        free(name);
         return NULL;
     }
-    if(driverId<=0){ // Checks if id is vaild.
+    return DriverCreateAt(driver,status,driver_name,driverId);
+}
+
+/**
+ ***** Function: DriverCreateAt *****
+ * Creates a new driver in the given memory, without copying its name.
+ * Used by the season, which keeps all its drivers in one block. Such a
+ * driver must not be destroyed with DriverDestroy, it goes away with its
+ * memory.
+ * @param memory - At least DriverGetSize() bytes, aligned for a pointer.
+ * @param status - will hold success or fail of the function.
+ * @param driver_name - A string which contains the driver's name. It must
+ * outlive the driver.
+ * @param driverId - A given id.
+ * @return return - NULL in case of failure or pointer to the created
+ * driver in case of success.
+ */
+Driver DriverCreateAt(void* memory, DriverStatus* status, char* driver_name,
+                      int driverId){
+    if (memory==NULL || driver_name==NULL || driverId<=0){
         if (status!=NULL){
             *status=INVALID_DRIVER;
         }
-        free(driver);
-        free(name);
         return NULL;
     }
     /* If we got here we can create a driver. */
+    Driver driver = memory;
     driver->id=driverId;
-    driver->driver_name=name;
+    driver->driver_name=driver_name;
+    driver->owns_name=false;
     driver->season_of_driver = NULL;
-    driver->points = 0;
+    driver->own_points = 0;
+    driver->points = &driver->own_points;
     driver->team = NULL; // On creatation 'driver' has no team.
     if (status!=NULL){
         *status=DRIVER_STATUS_OK;
@@ -70,6 +124,14 @@ Driver DriverCreate(DriverStatus* status, char* driver_name, int driverId){
     return driver;
 }
 
+/**
+ ***** Function: DriverGetSize *****
+ * @return - The number of bytes DriverCreateAt needs for a driver.
+ */
+size_t DriverGetSize(void){
+    return sizeof(struct driver);
+}
+
 /**
  ***** Function : DriverSetTeam *****
  * Description: assign the given team to the given driver.
@@ -129,27 +191,43 @@ int DriverGetId(Driver driver){
  */
 void DriverDestroy(Driver driver){
     if(driver!=NULL){
-        free(driver->driver_name);
+        if (driver->owns_name){
+            free(driver->driver_name);
+        }
         free(driver);
     }
 }
 
 /**
  ***** Function: DriverSetSeason *****
- * Description: assign the given season to the given driver.
+ * Description: assign the given season to the given driver and reset it's
+ * points. Assigning a driver its own season again takes its points from
+ * its team too. A driver moved to another season keeps its points itself
+ * again, and its former season is not told, as it may have been destroyed
+ * already.
  * @param driver - A pointer to a driver.
  * @param season - A pointer to a season.
  */
 void DriverSetSeason(Driver driver, Season season){
     if (driver!=NULL && season!=NULL){ // Both Pointers are valid.
-    driver->season_of_driver = season;
-    driver->points=0; // Reset it's points.
+        int change = -*driver->points;
+        bool same_season = driver->season_of_driver==season;
+        if (!same_season){
+            driver->own_points = *driver->points;
+            driver->points = &driver->own_points;
+        }
+        driver->season_of_driver = season;
+        *driver->points=0; // Reset it's points.
+        if (same_season){
+            DriverPointsChanged(driver,change);
+        }
     }
 }
 
 /**
  ***** Function: DriverAddRaceResult *****
- * Description: adds points to a driver by it's position.
+ * Description: adds points to a driver by it's position. The season of the
+ * driver adds them to the driver's team too.
  * @param driver - A pointer to a driver.
  * @param position - The driver's position in the last race.
  * @return - Success/failure of the function (if fails - with cause).
@@ -168,7 +246,9 @@ DriverStatus DriverAddRaceResult(Driver driver, int position){
         return INVALID_POSITION;
     }
     /* Adds points to a driver according to it's position. */
-    driver->points+=(SeasonGetNumberOfDrivers(driver->season_of_driver)-position);
+    int points = SeasonGetNumberOfDrivers(driver->season_of_driver)-position;
+    *driver->points+=points;
+    DriverPointsChanged(driver,points);
     return DRIVER_STATUS_OK;
 }
 
@@ -189,7 +269,44 @@ int DriverGetPoints(Driver driver, DriverStatus* status){
     if (status!=NULL) {
         *status = DRIVER_STATUS_OK;
     }
-    return driver->points;
+    return *driver->points;
+}
+
+/**
+ ***** Function: DriverSetPoints *****
+ * Description: sets driver's points, e.g. when a season is restored from a
+ * snapshot. The season of the driver updates the driver's team too.
+ * @param driver - A pointer to a driver.
+ * @param points - The new number of points of the driver.
+ * @return - Success/failure of the function (if fails - with cause).
+ */
+DriverStatus DriverSetPoints(Driver driver, int points){
+    if (driver==NULL){
+        return INVALID_DRIVER;
+    }
+    int change = points-*driver->points;
+    *driver->points = points;
+    DriverPointsChanged(driver,change);
+    return DRIVER_STATUS_OK;
+}
+
+/**
+ ***** Function: DriverSetPointsStorage *****
+ * Description: moves driver's points to the given storage, which the driver
+ * reads and updates from now on. Used by the season, which keeps the points
+ * of all its drivers in one array.
+ * @param driver - A pointer to a driver.
+ * @param points - The new storage of the points. It must outlive the driver,
+ * or its move to another season.
+ * @return - Success/failure of the function (if fails - with cause).
+ */
+DriverStatus DriverSetPointsStorage(Driver driver, int* points){
+    if (driver==NULL || points==NULL){
+        return INVALID_DRIVER;
+    }
+    *points = *driver->points;
+    driver->points = points;
+    return DRIVER_STATUS_OK;
 }
 
 /** Static functions */
@@ -201,4 +318,20 @@ int DriverGetPoints(Driver driver, DriverStatus* status){
 static Season DriverGetSeason(Driver driver){
     return driver->season_of_driver;
 }
+
+/**
+ ***** Static Function : DriverPointsChanged *****
+ * Description: tells the season of a driver about a change of the driver's
+ * points, after the change. Only a driver whose points are kept by its
+ * season is one of the season's drivers, and such a season is alive as
+ * long as the driver is.
+ * @param driver - A pointer to a driver.
+ * @param change - The points added to the driver (negative if taken).
+ */
+static void DriverPointsChanged(Driver driver, int change){
+    assert(driver!=NULL);
+    if (driver->points!=&driver->own_points){
+        SeasonDriverPointsChanged(driver->season_of_driver,driver,change);
+    }
+}
 /** End of static functions */
\ No newline at end of file
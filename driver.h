@@ -7,6 +7,8 @@
 
 typedef struct driver * Driver;
 
+#include <stddef.h>
+
 #include"team.h"
 #include"season.h"
 
@@ -20,6 +22,11 @@ typedef enum driverStatus {
 
 
 Driver DriverCreate(DriverStatus* status, char* driver_name, int driverId);
+Driver DriverCreateNoCopy(DriverStatus* status, char* driver_name,
+                          int driverId);
+Driver DriverCreateAt(void* memory, DriverStatus* status, char* driver_name,
+                      int driverId);
+size_t DriverGetSize(void);
 void   DriverDestroy(Driver driver);
 const char* DriverGetName(Driver driver);
 int DriverGetId(Driver driver);
@@ -28,6 +35,8 @@ void  DriverSetTeam(Driver driver, Team team);
 void  DriverSetSeason(Driver driver, Season season);
 DriverStatus DriverAddRaceResult(Driver driver, int position);
 int DriverGetPoints(Driver driver, DriverStatus* status);
+DriverStatus DriverSetPoints(Driver driver, int points);
+DriverStatus DriverSetPointsStorage(Driver driver, int* points);
 
 
 
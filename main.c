@@ -1,8 +1,13 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <pthread.h>
 #include "season.h"
+#include "scanner.h"
+#include "points.h"
+#include "simulator.h"
 
 Driver getDummyDriver() {
     return DriverCreate(NULL, "driver", 1);
@@ -116,6 +121,15 @@ void driverUnitTest() {
     DriverDestroy(driver6);
     Driver driver7 = DriverCreate(NULL, "driver7", 7);
     DriverDestroy(driver7);
+    char sharedName[] = "driver8";
+    Driver driver8 = DriverCreateNoCopy(&status, sharedName, 8);
+    assert(status == DRIVER_STATUS_OK && driver8);
+    assert(DriverGetName(driver8) == sharedName);
+    DriverDestroy(driver8);
+    assert(!DriverCreateNoCopy(&status, NULL, 9));
+    assert(status == INVALID_DRIVER);
+    assert(!DriverCreateNoCopy(&status, sharedName, 0));
+    assert(status == INVALID_DRIVER);
 }
 
 void teamUnitTest() {
@@ -195,6 +209,13 @@ void teamUnitTest() {
     assert(strcmp(TeamGetName(team5), nameBefore) != 0);
     assert(strcmp(TeamGetName(team5), "team5") == 0);
     TeamDestroy(team5);
+    char sharedName[] = "team6";
+    Team team6 = TeamCreateNoCopy(&status, sharedName);
+    assert(status == TEAM_STATUS_OK && team6);
+    assert(TeamGetName(team6) == sharedName);
+    TeamDestroy(team6);
+    assert(!TeamCreateNoCopy(&status, NULL));
+    assert(status == TEAM_NULL_PTR);
 }
 
 void testDriverPosition(Driver driver, char *name, int points) {
@@ -294,6 +315,19 @@ None\n\
     testDriverByPositionFunc(season1, 5, "Daniel", 2);
     testDriverByPositionFunc(season1, 6, "Max  Verstappen", 1);
     testDriverByPositionFunc(season1, 7, "Fernando Alonso", 0);
+    for (int i = 0; i < 7; i++) {
+        assert(SeasonGetDriverPosition(season1, driverStandings[i],
+                                       &status) == i + 1);
+        assert(status == SEASON_OK);
+    }
+    assert(!SeasonGetDriverPosition(NULL, driverStandings[0], &status));
+    assert(status == SEASON_NULL_PTR);
+    assert(!SeasonGetDriverPosition(season1, NULL, &status));
+    assert(status == SEASON_NULL_PTR);
+    Driver outsider = getDummyDriver();
+    assert(!SeasonGetDriverPosition(season1, outsider, &status));
+    assert(status == SEASON_NULL_PTR);
+    DriverDestroy(outsider);
     Team team = SeasonGetTeamByPosition(season1, 1, NULL);
     assert(team);
     team = SeasonGetTeamByPosition(NULL, 1, &status);
@@ -312,6 +346,26 @@ None\n\
     testTeamByPositionFunc(season1, 2, "Mercedes", 7);
     testTeamByPositionFunc(season1, 3, "RedBull Racing", 3);
     testTeamByPositionFunc(season1, 4, "McLaren", 0);
+    Driver driversBuffer[7];
+    assert(SeasonGetDriversStandingsInto(season1, driversBuffer, 7,
+                                         &status) == 7);
+    assert(status == SEASON_OK);
+    assert(memcmp(driversBuffer, driverStandings, sizeof(driversBuffer)) == 0);
+    assert(SeasonGetDriversStandingsInto(season1, driversBuffer, 6,
+                                         &status) == 7);
+    assert(status == SEASON_BUFFER_TOO_SMALL);
+    assert(!SeasonGetDriversStandingsInto(NULL, driversBuffer, 7, &status));
+    assert(status == SEASON_NULL_PTR);
+    assert(!SeasonGetDriversStandingsInto(season1, NULL, 7, &status));
+    assert(status == SEASON_NULL_PTR);
+    Team teamsBuffer[4];
+    assert(SeasonGetTeamsStandingsInto(season1, teamsBuffer, 4, &status) == 4);
+    assert(status == SEASON_OK);
+    assert(memcmp(teamsBuffer, teamStandings, sizeof(teamsBuffer)) == 0);
+    assert(SeasonGetTeamsStandingsInto(season1, teamsBuffer, 3, &status) == 4);
+    assert(status == SEASON_BUFFER_TOO_SMALL);
+    assert(!SeasonGetTeamsStandingsInto(NULL, teamsBuffer, 4, &status));
+    assert(status == SEASON_NULL_PTR);
     free(driverStandings);
     free(teamStandings);
     int results2[7] = {3, 4, 1, 2, 5, 7, 6};
@@ -332,6 +386,10 @@ None\n\
     testDriverByPositionFunc(season1, 5, "Daniel", 4);
     testDriverByPositionFunc(season1, 6, "Fernando Alonso", 1);
     testDriverByPositionFunc(season1, 7, "Max  Verstappen", 1);
+    for (int i = 0; i < 7; i++) {
+        assert(SeasonGetDriverPosition(season1, driverStandings[i],
+                                       NULL) == i + 1);
+    }
     testTeamPosition(teamStandings[0], "Mercedes", 18);
     testTeamPosition(teamStandings[1], "Ferrari", 18);
     testTeamPosition(teamStandings[2], "RedBull Racing", 5);
@@ -344,6 +402,26 @@ None\n\
     free(teamStandings);
     int results3[7] = {7, 1, 2, 3, 5, 4, 6};
     assert(SeasonAddRaceResult(season1, results3) == SEASON_OK);
+    Driver topDrivers[7];
+    assert(SeasonGetTopDrivers(season1, 3, topDrivers) == 3);
+    testDriverPosition(topDrivers[0], "Sebastian Vettel", 15);
+    testDriverPosition(topDrivers[1], "Lewis Hamilton", 13);
+    testDriverPosition(topDrivers[2], "Kimi Raikonen", 12);
+    assert(SeasonGetTopDrivers(season1, 10, topDrivers) == 7);
+    testDriverPosition(topDrivers[6], "Max  Verstappen", 1);
+    assert(!SeasonGetTopDrivers(season1, 0, topDrivers));
+    assert(!SeasonGetTopDrivers(NULL, 3, topDrivers));
+    Team topTeams[4];
+    assert(SeasonGetTopTeams(season1, 3, topTeams) == 3);
+    testTeamPosition(topTeams[0], "Ferrari", 27);
+    testTeamPosition(topTeams[1], "Mercedes", 22);
+    testTeamPosition(topTeams[2], "McLaren", 7);
+    assert(SeasonGetTopTeams(season1, 1, topTeams) == 1);
+    testTeamPosition(topTeams[0], "Ferrari", 27);
+    assert(SeasonGetTopTeams(season1, 5, topTeams) == 4);
+    testTeamPosition(topTeams[3], "RedBull Racing", 7);
+    assert(!SeasonGetTopTeams(season1, -1, topTeams));
+    assert(!SeasonGetTopTeams(season1, 3, NULL));
     driverStandings = SeasonGetDriversStandings(season1);
     teamStandings = SeasonGetTeamsStandings(season1);
     testDriverPosition(driverStandings[0], "Sebastian Vettel", 15);
@@ -389,6 +467,912 @@ None\n\
     SeasonDestroy(season4);
 }
 
+void seasonParsingTest() {
+    SeasonStatus status;
+    /* Empty lines are skipped and the last line may lack a '\n'. */
+    char *seasonInfo = "\
+\n\
+2018\n\
+\n\
+Ferrari\n\
+Sebastian Vettel\n\
+\n\
+Kimi Raikonen\n\
+McLaren\n\
+None\n\
+Fernando Alonso";
+    Season season = SeasonCreate(&status, seasonInfo);
+    assert(status == SEASON_OK && season);
+    assert(SeasonGetNumberOfTeams(season) == 2);
+    assert(SeasonGetNumberOfDrivers(season) == 3);
+    Team team = SeasonGetTeamByPosition(season, 2, &status);
+    assert(status == SEASON_OK);
+    assert(strcmp(TeamGetName(team), "McLaren") == 0);
+    assert(!TeamGetDriver(team, SECOND_DRIVER));
+    Driver driver = TeamGetDriver(team, FIRST_DRIVER);
+    assert(strcmp(DriverGetName(driver), "Fernando Alonso") == 0);
+    assert(DriverGetId(driver) == 3);
+    assert(DriverGetTeam(driver) == team);
+    SeasonDestroy(season);
+    /* Only a line which is exactly "None" means there is no driver. */
+    season = SeasonCreate(&status, "2018\nTeam\nNonea\nNone\n");
+    assert(status == SEASON_OK);
+    assert(SeasonGetNumberOfDrivers(season) == 1);
+    SeasonDestroy(season);
+    season = SeasonCreate(&status, "");
+    assert(status == SEASON_OK);
+    assert(!SeasonGetNumberOfTeams(season));
+    assert(!SeasonGetNumberOfDrivers(season));
+    SeasonDestroy(season);
+}
+
+void seasonFromFileTest() {
+    SeasonStatus status;
+    const char *path = "season_from_file_test.txt";
+    FILE *file = fopen(path, "w");
+    assert(file);
+    fputs("2018\nFerrari\nSebastian Vettel\nKimi Raikonen\n"
+          "McLaren\nFernando Alonso\nNone\n", file);
+    fclose(file);
+    Season season = SeasonCreateFromFile(&status, path);
+    assert(status == SEASON_OK && season);
+    assert(SeasonGetNumberOfTeams(season) == 2);
+    assert(SeasonGetNumberOfDrivers(season) == 3);
+    int results[3] = {3, 1, 2};
+    assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+    testDriverByPositionFunc(season, 1, "Fernando Alonso", 2);
+    testTeamByPositionFunc(season, 1, "McLaren", 2);
+    testTeamByPositionFunc(season, 2, "Ferrari", 1);
+    SeasonDestroy(season);
+    file = fopen(path, "w");
+    assert(file);
+    fclose(file);
+    season = SeasonCreateFromFile(&status, path);
+    assert(status == SEASON_OK && !SeasonGetNumberOfDrivers(season));
+    SeasonDestroy(season);
+    remove(path);
+    assert(!SeasonCreateFromFile(&status, path));
+    assert(status == SEASON_FILE_ERROR);
+    assert(!SeasonCreateFromFile(&status, NULL));
+    assert(status == BAD_SEASON_INFO);
+}
+
+void seasonSnapshotTest() {
+    SeasonStatus status;
+    const char *path = "season_snapshot_test.bin";
+    const char *seasonInfo = "\
+2018\n\
+Ferrari\n\
+Sebastian Vettel\n\
+Kimi Raikonen\n\
+Mercedes\n\
+Lewis Hamilton\n\
+Valtteri Bottas\n\
+McLaren\n\
+Fernando Alonso\n\
+None\n";
+    Season season = SeasonCreate(&status, seasonInfo);
+    assert(status == SEASON_OK);
+    assert(SeasonSave(season, path) == SEASON_OK);
+    Season loaded = SeasonLoad(&status, path);
+    assert(status == SEASON_OK && loaded);
+    assert(SeasonGetNumberOfTeams(loaded) == 3);
+    assert(SeasonGetNumberOfDrivers(loaded) == 5);
+    testDriverByPositionFunc(loaded, 1, "Sebastian Vettel", 0);
+    SeasonDestroy(loaded);
+    int race1[5] = {5, 3, 1, 4, 2};
+    int race2[5] = {1, 2, 3, 4, 5};
+    assert(SeasonAddRaceResult(season, race1) == SEASON_OK);
+    assert(SeasonAddRaceResult(season, race2) == SEASON_OK);
+    assert(SeasonSave(season, path) == SEASON_OK);
+    loaded = SeasonLoad(&status, path);
+    assert(status == SEASON_OK && loaded);
+    for (int position = 1; position <= 5; position++) {
+        Driver expected = SeasonGetDriverByPosition(season, position, NULL);
+        Driver driver = SeasonGetDriverByPosition(loaded, position, NULL);
+        assert(strcmp(DriverGetName(driver), DriverGetName(expected)) == 0);
+        assert(DriverGetId(driver) == DriverGetId(expected));
+        assert(DriverGetPoints(driver, NULL) ==
+               DriverGetPoints(expected, NULL));
+        assert(strcmp(TeamGetName(DriverGetTeam(driver)),
+                      TeamGetName(DriverGetTeam(expected))) == 0);
+    }
+    for (int position = 1; position <= 3; position++) {
+        Team expected = SeasonGetTeamByPosition(season, position, NULL);
+        Team team = SeasonGetTeamByPosition(loaded, position, NULL);
+        assert(strcmp(TeamGetName(team), TeamGetName(expected)) == 0);
+        assert(TeamGetPoints(team, NULL) == TeamGetPoints(expected, NULL));
+    }
+    /* The loaded season goes on from the last race of the saved one. */
+    assert(SeasonAddRaceResult(season, race1) == SEASON_OK);
+    assert(SeasonAddRaceResult(loaded, race1) == SEASON_OK);
+    for (int position = 1; position <= 5; position++) {
+        assert(DriverGetId(SeasonGetDriverByPosition(loaded, position, NULL)) ==
+               DriverGetId(SeasonGetDriverByPosition(season, position, NULL)));
+    }
+    SeasonDestroy(loaded);
+    SeasonDestroy(season);
+    FILE *file = fopen(path, "r+b");
+    assert(file);
+    fputs("F2", file);
+    fclose(file);
+    assert(!SeasonLoad(&status, path));
+    assert(status == BAD_SEASON_INFO);
+    remove(path);
+    assert(!SeasonLoad(&status, path));
+    assert(status == SEASON_FILE_ERROR);
+    assert(SeasonSave(NULL, path) == SEASON_NULL_PTR);
+}
+
+void seasonParserTest() {
+    SeasonStatus status;
+    const char *seasonInfo = "\
+2018\n\
+Ferrari\n\
+Sebastian Vettel\n\
+Kimi Raikonen\n\
+Mercedes\n\
+Lewis Hamilton\n\
+Valtteri Bottas\n\
+RedBull Racing\n\
+Daniel\n\
+Max  Verstappen\n\
+McLaren\n\
+Fernando Alonso\n\
+None";
+    int length = (int)strlen(seasonInfo);
+    /* Every chunk size cuts the lines at different places. */
+    for (int chunk = 1; chunk <= length; chunk++) {
+        SeasonParser parser = SeasonParserCreate(&status);
+        assert(status == SEASON_OK && parser);
+        for (int i = 0; i < length; i += chunk) {
+            int size = (length - i < chunk) ? length - i : chunk;
+            assert(SeasonParserFeed(parser, seasonInfo + i, (size_t)size) ==
+                   SEASON_OK);
+        }
+        Season season = SeasonParserFinish(parser, &status);
+        assert(status == SEASON_OK && season);
+        assert(SeasonGetNumberOfTeams(season) == 4);
+        assert(SeasonGetNumberOfDrivers(season) == 7);
+        int results[7] = {7, 1, 2, 3, 5, 4, 6};
+        assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+        testDriverByPositionFunc(season, 1, "Fernando Alonso", 6);
+        testDriverByPositionFunc(season, 7, "Max  Verstappen", 0);
+        testTeamByPositionFunc(season, 1, "Ferrari", 9);
+        SeasonDestroy(season);
+    }
+    assert(SeasonParserFeed(NULL, seasonInfo, 1) == SEASON_NULL_PTR);
+    assert(!SeasonParserFinish(NULL, &status));
+    assert(status == SEASON_NULL_PTR);
+    SeasonParser parser = SeasonParserCreate(NULL);
+    assert(SeasonParserFeed(parser, NULL, 0) == SEASON_OK);
+    assert(SeasonParserFeed(parser, NULL, 1) == SEASON_NULL_PTR);
+    assert(SeasonParserFeed(parser, seasonInfo, 20) == SEASON_OK);
+    SeasonParserDestroy(parser);
+    SeasonParserDestroy(NULL);
+}
+
+void standingsBackendTest() {
+    int results[3][7] = {{1, 2, 3, 4, 5, 6, 7},
+                         {3, 4, 1, 2, 5, 7, 6},
+                         {7, 1, 2, 3, 5, 4, 6}};
+    Season comparison = getDummySeason();
+    Season radix = getDummySeason();
+    assert(comparison && radix);
+    assert(SeasonSetStandingsBackend(NULL, STANDINGS_BACKEND_RADIX) ==
+           SEASON_NULL_PTR);
+    assert(SeasonSetStandingsBackend(comparison,
+                                     STANDINGS_BACKEND_COMPARISON) ==
+           SEASON_OK);
+    assert(SeasonSetStandingsBackend(radix, STANDINGS_BACKEND_RADIX) ==
+           SEASON_OK);
+    for (int race = 0; race < 3; race++) {
+        assert(SeasonAddRaceResult(comparison, results[race]) == SEASON_OK);
+        assert(SeasonAddRaceResult(radix, results[race]) == SEASON_OK);
+        for (int position = 1; position <= 7; position++) {
+            Driver expected = SeasonGetDriverByPosition(comparison, position,
+                                                        NULL);
+            Driver actual = SeasonGetDriverByPosition(radix, position, NULL);
+            assert(DriverGetId(expected) == DriverGetId(actual));
+        }
+    }
+    testDriverByPositionFunc(radix, 1, "Sebastian Vettel", 15);
+    testDriverByPositionFunc(radix, 7, "Max  Verstappen", 1);
+    SeasonDestroy(comparison);
+    SeasonDestroy(radix);
+}
+
+void standingsNetworkTest() {
+    /* Small rosters, with a driver alone in the last team when the number
+     * of drivers is odd, ranked by the network and by the comparison sort
+     * after races with many ties. */
+    int sizes[] = {1, 2, 3, 7, 20, 31, 32, 33};
+    srand(2018);
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(*sizes)); s++) {
+        int n = sizes[s];
+        char roster[1024];
+        int length = sprintf(roster, "2018\n");
+        for (int i = 0; i < n; i++) {
+            if (i % 2 == 0) {
+                length += sprintf(roster + length, "Team %d\n", i / 2);
+            }
+            length += sprintf(roster + length, "Driver %d\n", i);
+        }
+        Season comparison = SeasonCreate(NULL, roster);
+        Season network = SeasonCreate(NULL, roster);
+        Season automatic = SeasonCreate(NULL, roster);
+        assert(comparison && network && automatic);
+        assert(SeasonSetStandingsBackend(comparison,
+                                         STANDINGS_BACKEND_COMPARISON) ==
+               SEASON_OK);
+        assert(SeasonSetStandingsBackend(network,
+                                         STANDINGS_BACKEND_NETWORK) ==
+               SEASON_OK);
+        int results[33];
+        for (int race = 0; race <= 4; race++) {
+            if (race > 0) {
+                for (int i = 0; i < n; i++) {
+                    results[i] = i + 1;
+                }
+                for (int i = n - 1; i > 0; i--) {
+                    int j = rand() % (i + 1);
+                    int temp = results[i];
+                    results[i] = results[j];
+                    results[j] = temp;
+                }
+                assert(SeasonAddRaceResult(comparison, results) == SEASON_OK);
+                assert(SeasonAddRaceResult(network, results) == SEASON_OK);
+                assert(SeasonAddRaceResult(automatic, results) == SEASON_OK);
+            }
+            for (int position = 1; position <= n; position++) {
+                Driver expected = SeasonGetDriverByPosition(comparison,
+                                                            position, NULL);
+                assert(DriverGetId(SeasonGetDriverByPosition(network,
+                               position, NULL)) == DriverGetId(expected));
+                assert(DriverGetId(SeasonGetDriverByPosition(automatic,
+                               position, NULL)) == DriverGetId(expected));
+            }
+            for (int position = 1; position <= (n + 1) / 2; position++) {
+                Team expected = SeasonGetTeamByPosition(comparison, position,
+                                                        NULL);
+                Team actual = SeasonGetTeamByPosition(network, position,
+                                                      NULL);
+                assert(strcmp(TeamGetName(expected), TeamGetName(actual)) ==
+                       0);
+                assert(TeamGetPoints(expected, NULL) ==
+                       TeamGetPoints(actual, NULL));
+                actual = SeasonGetTeamByPosition(automatic, position, NULL);
+                assert(strcmp(TeamGetName(expected), TeamGetName(actual)) ==
+                       0);
+            }
+        }
+        SeasonDestroy(comparison);
+        SeasonDestroy(network);
+        SeasonDestroy(automatic);
+    }
+}
+
+void raceBatchTest() {
+    int results[3][7] = {{1, 2, 3, 4, 5, 6, 7},
+                         {3, 4, 1, 2, 5, 7, 6},
+                         {7, 1, 2, 3, 5, 4, 6}};
+    Season one_by_one = getDummySeason();
+    Season batch = getDummySeason();
+    assert(one_by_one && batch);
+    for (int race = 0; race < 3; race++) {
+        assert(SeasonAddRaceResult(one_by_one, results[race]) == SEASON_OK);
+    }
+    assert(SeasonAddRaceResults(NULL, results[0], 3) == SEASON_NULL_PTR);
+    assert(SeasonAddRaceResults(batch, NULL, 3) == SEASON_NULL_PTR);
+    assert(SeasonAddRaceResults(batch, results[0], -1) == BAD_RACE_RESULTS);
+    assert(SeasonAddRaceResults(batch, results[0], 0) == SEASON_OK);
+    assert(SeasonAddRaceResults(batch, results[0], 3) == SEASON_OK);
+    for (int position = 1; position <= 7; position++) {
+        Driver expected = SeasonGetDriverByPosition(one_by_one, position,
+                                                    NULL);
+        Driver actual = SeasonGetDriverByPosition(batch, position, NULL);
+        assert(DriverGetId(expected) == DriverGetId(actual));
+        assert(DriverGetPoints(expected, NULL) ==
+               DriverGetPoints(actual, NULL));
+    }
+    for (int position = 1; position <= 4; position++) {
+        Team expected = SeasonGetTeamByPosition(one_by_one, position, NULL);
+        Team actual = SeasonGetTeamByPosition(batch, position, NULL);
+        assert(strcmp(TeamGetName(expected), TeamGetName(actual)) == 0);
+        assert(TeamGetPoints(expected, NULL) == TeamGetPoints(actual, NULL));
+    }
+    /* A bad race anywhere in the batch leaves the season as it was. */
+    int bad_results[2][7] = {{1, 2, 3, 4, 5, 6, 7},
+                             {1, 2, 3, 4, 5, 6, 6}};
+    assert(SeasonAddRaceResults(batch, bad_results[0], 2) ==
+           BAD_RACE_RESULTS);
+    bad_results[1][6] = 8;
+    assert(SeasonAddRaceResults(batch, bad_results[0], 2) ==
+           BAD_RACE_RESULTS);
+    bad_results[1][6] = 7;
+    bad_results[1][0] = 0;
+    assert(SeasonAddRaceResult(batch, bad_results[1]) == BAD_RACE_RESULTS);
+    testDriverByPositionFunc(batch, 1, "Sebastian Vettel", 15);
+    testDriverByPositionFunc(batch, 7, "Max  Verstappen", 1);
+    SeasonDestroy(one_by_one);
+    SeasonDestroy(batch);
+}
+
+void assertSameStandings(Season first, Season second) {
+    int drivers = SeasonGetNumberOfDrivers(first);
+    int teams = SeasonGetNumberOfTeams(first);
+    assert(drivers == SeasonGetNumberOfDrivers(second));
+    assert(teams == SeasonGetNumberOfTeams(second));
+    for (int position = 1; position <= drivers; position++) {
+        Driver expected = SeasonGetDriverByPosition(first, position, NULL);
+        Driver actual = SeasonGetDriverByPosition(second, position, NULL);
+        assert(expected != actual);
+        assert(strcmp(DriverGetName(expected), DriverGetName(actual)) == 0);
+        assert(DriverGetPoints(expected, NULL) ==
+               DriverGetPoints(actual, NULL));
+        assert(strcmp(TeamGetName(DriverGetTeam(expected)),
+                      TeamGetName(DriverGetTeam(actual))) == 0);
+    }
+    for (int position = 1; position <= teams; position++) {
+        Team expected = SeasonGetTeamByPosition(first, position, NULL);
+        Team actual = SeasonGetTeamByPosition(second, position, NULL);
+        assert(strcmp(TeamGetName(expected), TeamGetName(actual)) == 0);
+        assert(TeamGetPoints(expected, NULL) == TeamGetPoints(actual, NULL));
+    }
+}
+
+void *seasonCloner(void *arg) {
+    return SeasonClone(arg, NULL);
+}
+
+void seasonCloneThreadsTest() {
+    /* Threads racing to make the first clone share one copy of the names,
+     * which outlives the season. */
+    Season season = getDummySeason();
+    assert(season);
+    pthread_t threads[4];
+    Season clones[4];
+    for (int i = 0; i < 4; i++) {
+        assert(pthread_create(&threads[i], NULL, seasonCloner, season) == 0);
+    }
+    for (int i = 0; i < 4; i++) {
+        void *clone;
+        assert(pthread_join(threads[i], &clone) == 0 && clone);
+        clones[i] = clone;
+    }
+    SeasonDestroy(season);
+    int results[7] = {7, 6, 5, 4, 3, 2, 1};
+    for (int i = 1; i < 4; i++) {
+        assert(DriverGetName(SeasonGetDriverByPosition(clones[i], 7, NULL)) ==
+               DriverGetName(SeasonGetDriverByPosition(clones[0], 7, NULL)));
+    }
+    for (int i = 0; i < 4; i++) {
+        assert(SeasonAddRaceResult(clones[i], results) == SEASON_OK);
+        testDriverByPositionFunc(clones[i], 1, "Fernando Alonso", 6);
+        testTeamByPositionFunc(clones[i], 1, "RedBull Racing", 9);
+        SeasonDestroy(clones[i]);
+    }
+}
+
+/* The teams standings of a season must agree with TeamGetPoints. */
+static void assertTeamsStandingsMatchTeams(Season season) {
+    Team* standings = SeasonGetTeamsStandings(season);
+    assert(standings);
+    for (int position = 1; position <= SeasonGetNumberOfTeams(season);
+         position++) {
+        Team team = SeasonGetTeamByPosition(season, position, NULL);
+        assert(standings[position - 1] == team);
+        assert(position == 1 || TeamGetPoints(team, NULL) <=
+                                TeamGetPoints(standings[position - 2], NULL));
+    }
+    free(standings);
+}
+
+void driverPointsInSeasonTest() {
+    int results[7] = {1, 2, 3, 4, 5, 6, 7};
+    Season season = getDummySeason();
+    assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+    /* Alonso, alone in McLaren, is last with 0 points. */
+    Driver alonso = SeasonGetDriverByPosition(season, 7, NULL);
+    assert(DriverAddRaceResult(alonso, 1) == DRIVER_STATUS_OK);
+    testDriverByPositionFunc(season, 2, "Fernando Alonso", 6);
+    testTeamByPositionFunc(season, 3, "McLaren", 6);
+    assertTeamsStandingsMatchTeams(season);
+    assert(DriverSetPoints(alonso, 20) == DRIVER_STATUS_OK);
+    testDriverByPositionFunc(season, 1, "Fernando Alonso", 20);
+    testTeamByPositionFunc(season, 1, "McLaren", 20);
+    assertTeamsStandingsMatchTeams(season);
+    /* Assigning Vettel his season again takes his points from Ferrari. */
+    Driver vettel = SeasonGetDriverByPosition(season, 2, NULL);
+    DriverSetSeason(vettel, season);
+    testDriverByPositionFunc(season, 2, "Kimi Raikonen", 5);
+    testDriverByPositionFunc(season, 7, "Sebastian Vettel", 0);
+    testTeamByPositionFunc(season, 3, "Ferrari", 5);
+    assertTeamsStandingsMatchTeams(season);
+    /* The next race still adds to the right totals. */
+    assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+    testTeamByPositionFunc(season, 1, "McLaren", 20);
+    testTeamByPositionFunc(season, 2, "Ferrari", 16);
+    assertTeamsStandingsMatchTeams(season);
+    SeasonDestroy(season);
+    /* A driver doesn't tell a season it has left, which may be gone. */
+    Driver driver = getDummyDriver();
+    Season first = getDummySeason();
+    Season second = getDummySeason();
+    DriverSetSeason(driver, first);
+    SeasonDestroy(first);
+    DriverSetSeason(driver, second);
+    assert(DriverAddRaceResult(driver, 1) == DRIVER_STATUS_OK);
+    assert(DriverGetPoints(driver, NULL) == 6);
+    testDriverByPositionFunc(second, 1, "Sebastian Vettel", 0);
+    DriverDestroy(driver);
+    SeasonDestroy(second);
+    /* A driver moved out of a season no longer uses its points array. */
+    driver = getDummyDriver();
+    first = getDummySeason();
+    second = getDummySeason();
+    int* first_points = malloc(sizeof(*first_points));
+    assert(first_points);
+    DriverSetSeason(driver, first);
+    assert(DriverSetPointsStorage(driver, first_points) == DRIVER_STATUS_OK);
+    assert(DriverAddRaceResult(driver, 2) == DRIVER_STATUS_OK);
+    assert(*first_points == 5);
+    DriverSetSeason(driver, second);
+    assert(*first_points == 5);
+    free(first_points);
+    SeasonDestroy(first);
+    assert(DriverGetPoints(driver, NULL) == 0);
+    assert(DriverAddRaceResult(driver, 1) == DRIVER_STATUS_OK);
+    assert(DriverSetPoints(driver, 3) == DRIVER_STATUS_OK);
+    assert(DriverGetPoints(driver, NULL) == 3);
+    DriverDestroy(driver);
+    SeasonDestroy(second);
+}
+
+void seasonCloneTest() {
+    SeasonStatus status;
+    assert(SeasonClone(NULL, &status) == NULL && status == SEASON_NULL_PTR);
+    int results[3][7] = {{3, 4, 1, 2, 5, 7, 6},
+                         {1, 2, 3, 4, 5, 6, 7},
+                         {7, 1, 2, 3, 5, 4, 6}};
+    Season season = getDummySeason();
+    Season replay = getDummySeason();
+    assert(season && replay);
+    Season before_races = SeasonClone(season, &status);
+    assert(status == SEASON_OK && before_races);
+    assertSameStandings(season, before_races);
+    assert(SeasonAddRaceResult(season, results[0]) == SEASON_OK);
+    assert(SeasonAddRaceResult(replay, results[0]) == SEASON_OK);
+    Season clone = SeasonClone(season, &status);
+    assert(status == SEASON_OK && clone);
+    assertSameStandings(season, clone);
+    /* The clone and the season go their own ways. */
+    assert(SeasonAddRaceResult(clone, results[1]) == SEASON_OK);
+    assertSameStandings(season, replay);
+    assert(SeasonAddRaceResult(season, results[2]) == SEASON_OK);
+    assert(SeasonAddRaceResult(replay, results[2]) == SEASON_OK);
+    assertSameStandings(season, replay);
+    testDriverByPositionFunc(before_races, 1, "Sebastian Vettel", 0);
+    assert(SeasonAddRaceResults(before_races, results[0], 2) == SEASON_OK);
+    assertSameStandings(before_races, clone);
+    /* Clones keep the shared names after the season is destroyed. */
+    Season clone_of_clone = SeasonClone(clone, NULL);
+    assert(clone_of_clone);
+    SeasonDestroy(season);
+    SeasonDestroy(clone);
+    assert(SeasonAddRaceResult(before_races, results[2]) == SEASON_OK);
+    assert(SeasonAddRaceResult(clone_of_clone, results[2]) == SEASON_OK);
+    assertSameStandings(before_races, clone_of_clone);
+    testDriverByPositionFunc(clone_of_clone, 1, "Sebastian Vettel", 15);
+    SeasonDestroy(before_races);
+    SeasonDestroy(clone_of_clone);
+    SeasonDestroy(replay);
+    /* A season parsed in chunks keeps its names outside of a block. */
+    SeasonParser parser = SeasonParserCreate(NULL);
+    const char *seasonInfo = "2018\nFerrari\nSebastian Vettel\nNone\n"
+                             "Mercedes\nLewis Hamilton\nValtteri Bottas\n";
+    assert(SeasonParserFeed(parser, seasonInfo, 20) == SEASON_OK);
+    assert(SeasonParserFeed(parser, seasonInfo + 20,
+                            strlen(seasonInfo) - 20) == SEASON_OK);
+    season = SeasonParserFinish(parser, NULL);
+    assert(season);
+    clone = SeasonClone(season, NULL);
+    assert(clone);
+    SeasonDestroy(season);
+    int short_results[3] = {2, 1, 3};
+    assert(SeasonAddRaceResult(clone, short_results) == SEASON_OK);
+    testDriverByPositionFunc(clone, 1, "Lewis Hamilton", 2);
+    testTeamByPositionFunc(clone, 1, "Mercedes", 2);
+    SeasonDestroy(clone);
+}
+
+void scannerTest() {
+    char data[300];
+    size_t expected[300], newlines[300];
+    unsigned int seed = 2018;
+    for (int i = 0; i < 300; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = ((seed >> 16) % 5 == 0) ? '\n' : 'a';
+    }
+    assert(ScannerBackendIsSupported(SCANNER_BACKEND_AUTO));
+    assert(ScannerBackendIsSupported(SCANNER_BACKEND_SCALAR));
+    ScannerBackend backends[] = {SCANNER_BACKEND_AUTO, SCANNER_BACKEND_SCALAR,
+                                 SCANNER_BACKEND_SSE2, SCANNER_BACKEND_AVX2};
+    /* Every backend (unsupported ones fall back to scalar) finds the same
+     * newlines at every offset, length and capacity. */
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t length = 0; length + offset <= 300; length += 7) {
+            size_t count = 0;
+            for (size_t i = 0; i < length; i++) {
+                if (data[offset + i] == '\n') {
+                    expected[count++] = i;
+                }
+            }
+            for (int b = 0; b < 4; b++) {
+                for (size_t capacity = 0; capacity <= count + 1;
+                     capacity += 3) {
+                    size_t found = ScannerFindNewlines(backends[b],
+                                                       data + offset, length,
+                                                       newlines, capacity);
+                    assert(found == (capacity < count ? capacity : count));
+                    assert(!memcmp(newlines, expected,
+                                   found * sizeof(*newlines)));
+                }
+            }
+        }
+    }
+    assert(!ScannerFindNewlines(SCANNER_BACKEND_AUTO, NULL, 5, newlines, 5));
+}
+
+void pointsTest() {
+    int results[1000], expected[1000], points[1000];
+    PointsBackend backends[] = {POINTS_BACKEND_AUTO, POINTS_BACKEND_SCALAR,
+                                POINTS_BACKEND_AVX2, POINTS_BACKEND_AVX512};
+    assert(PointsBackendIsSupported(POINTS_BACKEND_AUTO));
+    assert(PointsBackendIsSupported(POINTS_BACKEND_SCALAR));
+    unsigned int seed = 2018;
+    /* Every backend (unsupported ones fall back to scalar) adds the same
+     * points, for rosters around the vector widths and a big one. */
+    for (int n = 1; n <= 1000; n = (n < 40) ? n + 1 : n * 5) {
+        for (int i = 0; i < n; i++) {
+            results[i] = i + 1;
+        }
+        for (int i = n - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            int j = (int)((seed >> 8) % (unsigned int)(i + 1));
+            int temp = results[i];
+            results[i] = results[j];
+            results[j] = temp;
+        }
+        /* Driver 'id' starts with id-1 points. */
+        for (int i = 0; i < n; i++) {
+            expected[results[i] - 1] = (results[i] - 1) + n - (i + 1);
+        }
+        for (int b = 0; b < 4; b++) {
+            for (int i = 0; i < n; i++) {
+                points[i] = i;
+            }
+            PointsAddRace(backends[b], points, results, n);
+            assert(!memcmp(points, expected, n * sizeof(*points)));
+        }
+    }
+    PointsAddRace(POINTS_BACKEND_AUTO, NULL, results, 5);
+}
+
+void pointsFuturesTest() {
+    enum { MAX_ENTRIES = 20, MAX_FUTURES = 40 };
+    int points[MAX_ENTRIES * MAX_FUTURES], positions[MAX_ENTRIES * MAX_FUTURES];
+    int expected[MAX_ENTRIES * MAX_FUTURES], actual[MAX_ENTRIES * MAX_FUTURES];
+    PointsBackend backends[] = {POINTS_BACKEND_AUTO, POINTS_BACKEND_SCALAR,
+                                POINTS_BACKEND_AVX2, POINTS_BACKEND_AVX512};
+    unsigned int seed = 2018;
+    /* Few distinct points and positions, so the ties need every rule. */
+    for (int count = 1; count <= MAX_ENTRIES; count += 3) {
+        for (int futures = 1; futures <= MAX_FUTURES; futures += 7) {
+            int size = count * futures;
+            for (int x = 0; x < size; x++) {
+                seed = seed * 1103515245u + 12345u;
+                points[x] = (int)((seed >> 8) % 4);
+                positions[x] = (int)((seed >> 16) % 4);
+            }
+            PointsRankFutures(POINTS_BACKEND_SCALAR, points, positions,
+                              count, futures, expected);
+            /* In every future the ranks are a permutation, in the order of
+             * the standings. */
+            for (int f = 0; f < futures; f++) {
+                int by_rank[MAX_ENTRIES];
+                memset(by_rank, -1, sizeof(by_rank));
+                for (int i = 0; i < count; i++) {
+                    int rank = expected[i * futures + f];
+                    assert(rank >= 1 && rank <= count);
+                    assert(by_rank[rank - 1] == -1);
+                    by_rank[rank - 1] = i;
+                }
+                for (int r = 1; r < count; r++) {
+                    int first = by_rank[r - 1] * futures + f;
+                    int second = by_rank[r] * futures + f;
+                    assert(points[first] > points[second] ||
+                           (points[first] == points[second] &&
+                            (positions[first] < positions[second] ||
+                             (positions[first] == positions[second] &&
+                              by_rank[r - 1] < by_rank[r]))));
+                }
+            }
+            for (int b = 0; b < 4; b++) {
+                PointsRankFutures(backends[b], points, positions, count,
+                                  futures, actual);
+                assert(!memcmp(actual, expected, size * sizeof(*actual)));
+            }
+            /* A race gives the driver in position p count-p points. */
+            for (int x = 0; x < size; x++) {
+                positions[x] = 1 + x / futures;
+                expected[x] = points[x] + count - positions[x];
+            }
+            for (int b = 0; b < 4; b++) {
+                memcpy(actual, points, size * sizeof(*actual));
+                PointsAddRaceFutures(backends[b], actual, positions, count,
+                                     futures);
+                assert(!memcmp(actual, expected, size * sizeof(*actual)));
+            }
+        }
+    }
+    PointsAddRaceFutures(POINTS_BACKEND_AUTO, NULL, positions, 5, 5);
+    PointsRankFutures(POINTS_BACKEND_AUTO, points, positions, 5, 5, NULL);
+}
+
+void concurrentReadsTest() {
+    Season season = getDummySeason();
+    assert(season);
+    SeasonStatus status;
+    assert(SeasonReaderCreate(season, &status) == NULL);
+    assert(status == SEASON_NO_READER_SLOT);
+    assert(SeasonEnableConcurrentReads(NULL, 2) == SEASON_NULL_PTR);
+    assert(SeasonEnableConcurrentReads(season, 0) == SEASON_NO_READER_SLOT);
+    assert(SeasonEnableConcurrentReads(season, 2) == SEASON_OK);
+    assert(SeasonEnableConcurrentReads(season, 2) == SEASON_OK);
+    SeasonReader first = SeasonReaderCreate(season, &status);
+    SeasonReader second = SeasonReaderCreate(season, &status);
+    assert(first && second && status == SEASON_OK);
+    assert(SeasonReaderCreate(season, &status) == NULL);
+    assert(status == SEASON_NO_READER_SLOT);
+    int results[7] = {3, 4, 1, 2, 5, 7, 6};
+    assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+    /* Pinned standings don't change while races are added. */
+    SeasonStandings pinned = SeasonReaderBegin(first);
+    int points;
+    Driver leader = SeasonStandingsGetDriverByPosition(pinned, 1, &points);
+    assert(DriverGetId(leader) == 3 && points == 6);
+    assert(SeasonStandingsGetDriverPosition(pinned, leader, NULL) == 1);
+    assert(SeasonStandingsGetDriverByPosition(pinned, 8, NULL) == NULL);
+    Team team = SeasonStandingsGetTeamByPosition(pinned, 1, &points);
+    assert(strcmp(TeamGetName(team), "Mercedes") == 0 && points == 11);
+    assert(SeasonStandingsGetTeamByPosition(pinned, 5, NULL) == NULL);
+    int reversed[7] = {6, 7, 5, 2, 1, 4, 3};
+    for (int race = 0; race < 4; race++) {
+        assert(SeasonAddRaceResult(season, reversed) == SEASON_OK);
+    }
+    assert(SeasonStandingsGetDriverByPosition(pinned, 1, &points) == leader);
+    assert(points == 6);
+    SeasonStandings latest = SeasonReaderBegin(second);
+    assert(latest != pinned);
+    assert(DriverGetId(SeasonStandingsGetDriverByPosition(latest, 1,
+                                                          &points)) == 6);
+    assert(points == 4 * 6);
+    assert(SeasonStandingsGetDriverPosition(latest, leader, &points) == 7);
+    assert(points == 6);
+    /* A driver of another season has no position. */
+    Driver stranger = getDummyDriver();
+    assert(SeasonStandingsGetDriverPosition(latest, stranger, NULL) == 0);
+    DriverDestroy(stranger);
+    SeasonReaderEnd(second);
+    SeasonReaderEnd(first);
+    SeasonReaderDestroy(second);
+    second = SeasonReaderCreate(season, &status);
+    assert(second && status == SEASON_OK);
+    /* A change of points made through a driver is published too. */
+    assert(DriverSetPoints(leader, 100) == DRIVER_STATUS_OK);
+    latest = SeasonReaderBegin(second);
+    assert(SeasonStandingsGetDriverByPosition(latest, 1, &points) == leader);
+    assert(points == 100);
+    SeasonReaderEnd(second);
+    SeasonReaderDestroy(first);
+    SeasonReaderDestroy(second);
+    SeasonDestroy(season);
+}
+
+typedef struct standingsReaderArgs {
+    SeasonReader reader;
+    int drivers;
+    int teams;
+    volatile int* done;
+} StandingsReaderArgs;
+
+void *standingsReader(void *arg) {
+    StandingsReaderArgs *args = arg;
+    while (!__atomic_load_n(args->done, __ATOMIC_ACQUIRE)) {
+        SeasonStandings standings = SeasonReaderBegin(args->reader);
+        int drivers_total = 0, teams_total = 0, previous = -1;
+        for (int position = args->drivers; position >= 1; position--) {
+            int points;
+            Driver driver = SeasonStandingsGetDriverByPosition(standings,
+                                                               position,
+                                                               &points);
+            assert(points >= previous);
+            assert(SeasonStandingsGetDriverPosition(standings, driver,
+                                                    NULL) == position);
+            previous = points;
+            drivers_total += points;
+        }
+        for (int position = 1; position <= args->teams; position++) {
+            int points;
+            assert(SeasonStandingsGetTeamByPosition(standings, position,
+                                                    &points));
+            teams_total += points;
+        }
+        /* Every driver in the dummy season has a team. */
+        assert(drivers_total == teams_total);
+        SeasonReaderEnd(args->reader);
+    }
+    return NULL;
+}
+
+void concurrentReadsThreadsTest() {
+    Season season = getDummySeason();
+    assert(season);
+    assert(SeasonEnableConcurrentReads(season, 3) == SEASON_OK);
+    volatile int done = 0;
+    pthread_t threads[3];
+    StandingsReaderArgs args[3];
+    for (int i = 0; i < 3; i++) {
+        args[i] = (StandingsReaderArgs){SeasonReaderCreate(season, NULL),
+                                        7, 4, &done};
+        assert(args[i].reader);
+        assert(pthread_create(&threads[i], NULL, standingsReader,
+                              &args[i]) == 0);
+    }
+    int results[7] = {1, 2, 3, 4, 5, 6, 7};
+    for (int race = 0; race < 20000; race++) {
+        for (int i = 6; i > 0; i--) { // A different order every race.
+            int j = (race * 7 + i * 3) % (i + 1);
+            int id = results[i];
+            results[i] = results[j];
+            results[j] = id;
+        }
+        assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+    }
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < 3; i++) {
+        pthread_join(threads[i], NULL);
+        SeasonReaderDestroy(args[i].reader);
+    }
+    SeasonDestroy(season);
+}
+
+void simulatorTest() {
+    SimulatorStatus status;
+    assert(SimulatorCreate(NULL, &status) == NULL);
+    assert(status == SIMULATOR_NULL_PTR);
+    Season season = getDummySeason();
+    int results[7] = {3, 4, 1, 2, 5, 7, 6};
+    assert(SeasonAddRaceResult(season, results) == SEASON_OK);
+    Simulator simulator = SimulatorCreate(season, &status);
+    assert(status == SIMULATOR_OK && simulator);
+    Driver drivers[7];
+    Team teams[4];
+    assert(SeasonGetRaceState(season, drivers, NULL, NULL, NULL, teams) ==
+           SEASON_OK);
+    assert(SimulatorRun(NULL, 1, 1, 1, 0) == SIMULATOR_NULL_PTR);
+    assert(SimulatorRun(simulator, -1, 1, 1, 0) == SIMULATOR_BAD_ARGUMENT);
+    assert(SimulatorRun(simulator, 1, 0, 1, 0) == SIMULATOR_BAD_ARGUMENT);
+    assert(SimulatorRun(simulator, 1, 1, 0, 0) == SIMULATOR_BAD_ARGUMENT);
+    assert(SimulatorGetTitleProbability(simulator, drivers[0]) == 0);
+    assert(SimulatorSetDriverStrength(simulator, drivers[0], 0) ==
+           SIMULATOR_BAD_ARGUMENT);
+    Driver stranger = getDummyDriver();
+    assert(SimulatorSetDriverStrength(simulator, stranger, 1) ==
+           SIMULATOR_BAD_ARGUMENT);
+    /* Without races left the current standings are certain. */
+    assert(SimulatorRun(simulator, 0, 100, 2, 1) == SIMULATOR_OK);
+    for (int position = 1; position <= 7; position++) {
+        Driver driver = SeasonGetDriverByPosition(season, position, NULL);
+        assert(SimulatorGetTitleProbability(simulator, driver) ==
+               (position == 1));
+        assert(SimulatorGetTopThreeProbability(simulator, driver) ==
+               (position <= 3));
+    }
+    for (int position = 1; position <= 4; position++) {
+        Team team = SeasonGetTeamByPosition(season, position, NULL);
+        assert(SimulatorGetConstructorsTitleProbability(simulator, team) ==
+               (position == 1));
+    }
+    assert(SimulatorGetTitleProbability(simulator, stranger) == 0);
+    DriverDestroy(stranger);
+    /* Strengths far apart make the race almost certain, and then the
+     * simulated standings are the ones of the season after that race. All
+     * the drivers end up with 6 points, so only the tie-breaks decide. */
+    int race[7] = {6, 7, 5, 2, 1, 4, 3};
+    double strength = 1;
+    for (int position = 6; position >= 0; position--) {
+        Driver driver = drivers[race[position] - 1];
+        assert(SimulatorSetDriverStrength(simulator, driver, strength) ==
+               SIMULATOR_OK);
+        strength *= 1e6;
+    }
+    assert(SimulatorRun(simulator, 1, 5000, 3, 7) == SIMULATOR_OK);
+    assert(SeasonAddRaceResult(season, race) == SEASON_OK);
+    Driver first = SeasonGetDriverByPosition(season, 1, NULL);
+    Driver fourth = SeasonGetDriverByPosition(season, 4, NULL);
+    assert(SimulatorGetTitleProbability(simulator, first) > 0.99);
+    assert(SimulatorGetTopThreeProbability(simulator, fourth) < 0.01);
+    Team champions = SeasonGetTeamByPosition(season, 1, NULL);
+    assert(strcmp(TeamGetName(champions), "RedBull Racing") == 0);
+    assert(SimulatorGetConstructorsTitleProbability(simulator, champions) >
+           0.99);
+    SimulatorDestroy(simulator);
+    SeasonDestroy(season);
+    /* The strengths are win probabilities, and the results don't depend on
+     * the number of threads. */
+    season = getDummySeason();
+    simulator = SimulatorCreate(season, NULL);
+    Simulator threaded = SimulatorCreate(season, NULL);
+    assert(SeasonGetRaceState(season, drivers, NULL, NULL, NULL, NULL) ==
+           SEASON_OK);
+    assert(SimulatorSetDriverStrength(simulator, drivers[0], 4) ==
+           SIMULATOR_OK);
+    assert(SimulatorSetDriverStrength(threaded, drivers[0], 4) ==
+           SIMULATOR_OK);
+    assert(SimulatorRun(simulator, 1, 100000, 1, 2018) == SIMULATOR_OK);
+    assert(SimulatorRun(threaded, 1, 100000, 4, 2018) == SIMULATOR_OK);
+    double title = SimulatorGetTitleProbability(simulator, drivers[0]);
+    assert(title > 0.39 && title < 0.41); // 4/(4+6).
+    double titles = 0, top_three = 0;
+    for (int i = 0; i < 7; i++) {
+        assert(SimulatorGetTitleProbability(simulator, drivers[i]) ==
+               SimulatorGetTitleProbability(threaded, drivers[i]));
+        assert(SimulatorGetTopThreeProbability(simulator, drivers[i]) ==
+               SimulatorGetTopThreeProbability(threaded, drivers[i]));
+        titles += SimulatorGetTitleProbability(simulator, drivers[i]);
+        top_three += SimulatorGetTopThreeProbability(simulator, drivers[i]);
+    }
+    assert(titles > 0.999 && titles < 1.001);
+    assert(top_three > 2.999 && top_three < 3.001);
+    SimulatorDestroy(simulator);
+    SimulatorDestroy(threaded);
+    SeasonDestroy(season);
+    /* A roster too big for the ranking kernel, with a driver alone in the
+     * last team. */
+    char roster[2048];
+    int length = sprintf(roster, "2018\n");
+    for (int i = 0; i < 41; i++) {
+        if (i % 2 == 0) {
+            length += sprintf(roster + length, "Team %d\n", i / 2);
+        }
+        length += sprintf(roster + length, "Driver %d\n", i);
+    }
+    season = SeasonCreate(NULL, roster);
+    int big_race[41];
+    for (int i = 0; i < 41; i++) {
+        big_race[i] = (i * 17) % 41 + 1;
+    }
+    assert(SeasonAddRaceResult(season, big_race) == SEASON_OK);
+    simulator = SimulatorCreate(season, NULL);
+    assert(SimulatorRun(simulator, 0, 10, 1, 0) == SIMULATOR_OK);
+    for (int position = 1; position <= 41; position++) {
+        Driver driver = SeasonGetDriverByPosition(season, position, NULL);
+        assert(SimulatorGetTitleProbability(simulator, driver) ==
+               (position == 1));
+        assert(SimulatorGetTopThreeProbability(simulator, driver) ==
+               (position <= 3));
+    }
+    for (int position = 1; position <= 21; position++) {
+        Team team = SeasonGetTeamByPosition(season, position, NULL);
+        assert(SimulatorGetConstructorsTitleProbability(simulator, team) ==
+               (position == 1));
+    }
+    SimulatorDestroy(simulator);
+    SeasonDestroy(season);
+}
+
 void exampleTest() {
     DriverStatus driver_status;
     TeamStatus team_status;
@@ -429,6 +1413,22 @@ int main() {
     driverUnitTest();
     teamUnitTest();
     seasonUnitTest();
+    seasonParsingTest();
+    seasonFromFileTest();
+    seasonSnapshotTest();
+    seasonParserTest();
+    standingsBackendTest();
+    standingsNetworkTest();
+    raceBatchTest();
+    driverPointsInSeasonTest();
+    seasonCloneTest();
+    seasonCloneThreadsTest();
+    scannerTest();
+    pointsTest();
+    pointsFuturesTest();
+    concurrentReadsTest();
+    concurrentReadsThreadsTest();
+    simulatorTest();
     exampleTest();
     return 0;
 }
\ No newline at end of file
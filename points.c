@@ -0,0 +1,483 @@
+#include <assert.h>
+#include "points.h"
+
+/* The vector backends are built for x86 with GCC or Clang, which can compile
+ * a function for an instruction set the whole program isn't built for. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POINTS_X86
+#include <immintrin.h>
+#endif
+
+/** Declarations */
+static PointsBackend PointsBestBackend(void);
+static PointsBackend PointsSelectBackend(PointsBackend backend);
+static void PointsAddRaceScalar(int* points, const int* results,
+                                int number_of_drivers, int first);
+static void PointsAddRaceFuturesScalar(int* points, const int* positions,
+                                       int number_of_drivers, size_t first,
+                                       size_t size);
+static void PointsRankFuturesScalar(const int* points, const int* positions,
+                                    int count, int futures, int first,
+                                    int* ranks);
+#ifdef POINTS_X86
+static void PointsAddRaceAvx2(int* points, const int* results,
+                              int number_of_drivers);
+static void PointsAddRaceAvx512(int* points, const int* results,
+                                int number_of_drivers);
+static void PointsAddRaceFuturesAvx2(int* points, const int* positions,
+                                     int number_of_drivers, size_t size);
+static void PointsAddRaceFuturesAvx512(int* points, const int* positions,
+                                       int number_of_drivers, size_t size);
+static void PointsRankFuturesAvx2(const int* points, const int* positions,
+                                  int count, int futures, int* ranks);
+static void PointsRankFuturesAvx512(const int* points, const int* positions,
+                                    int count, int futures, int* ranks);
+#endif
+/** End of declarations */
+
+/**
+ ***** Function: PointsBackendIsSupported *****
+ * Description: checks if a backend can run on this machine.
+ * @param backend - A points backend.
+ * @return - True if the backend can be used, else false. The automatic and
+ * scalar backends are always supported.
+ */
+bool PointsBackendIsSupported(PointsBackend backend){
+    switch (backend){
+        case POINTS_BACKEND_AUTO:
+        case POINTS_BACKEND_SCALAR:
+            return true;
+#ifdef POINTS_X86
+        case POINTS_BACKEND_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case POINTS_BACKEND_AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ ***** Function: PointsAddRace *****
+ * Description: adds the points of a race to the drivers: the driver in
+ * position p (1 is the winner) gets number_of_drivers-p points. The
+ * automatic backend picks the widest backend the machine supports, and an
+ * unsupported backend falls back to the scalar one.
+ * @param backend - The backend to add with.
+ * @param points - points[id-1] is the number of points of the driver 'id'.
+ * @param results - The ids of the drivers by their position in the race.
+ * Every id must appear once, so the vector backends may update several
+ * drivers at a time.
+ * @param number_of_drivers - Number of drivers in the race.
+ */
+void PointsAddRace(PointsBackend backend, int* points, const int* results,
+                   int number_of_drivers){
+    if (points==NULL || results==NULL || number_of_drivers<=0){
+        return;
+    }
+    switch (PointsSelectBackend(backend)){
+#ifdef POINTS_X86
+        case POINTS_BACKEND_AVX2:
+            PointsAddRaceAvx2(points, results, number_of_drivers);
+            return;
+        case POINTS_BACKEND_AVX512:
+            PointsAddRaceAvx512(points, results, number_of_drivers);
+            return;
+#endif
+        default:
+            PointsAddRaceScalar(points, results, number_of_drivers, 0);
+    }
+}
+
+/**
+ ***** Function: PointsAddRaceFutures *****
+ * Description: adds the points of a race to many independent futures of a
+ * season at once. The futures are interleaved: element i*futures+f of an
+ * array belongs to driver i in future f, so a vector holds one driver in
+ * consecutive futures and a single instruction scores it in all of them.
+ * @param backend - The backend to add with.
+ * @param points - The points of the drivers in every future.
+ * @param positions - The positions of the drivers in the race of every
+ * future (1 is the winner), interleaved like the points.
+ * @param number_of_drivers - Number of drivers in the race.
+ * @param futures - Number of futures.
+ */
+void PointsAddRaceFutures(PointsBackend backend, int* points,
+                          const int* positions, int number_of_drivers,
+                          int futures){
+    if (points==NULL || positions==NULL || number_of_drivers<=0 ||
+        futures<=0){
+        return;
+    }
+    size_t size = (size_t)number_of_drivers*(size_t)futures;
+    switch (PointsSelectBackend(backend)){
+#ifdef POINTS_X86
+        case POINTS_BACKEND_AVX2:
+            PointsAddRaceFuturesAvx2(points, positions, number_of_drivers,
+                                     size);
+            return;
+        case POINTS_BACKEND_AVX512:
+            PointsAddRaceFuturesAvx512(points, positions, number_of_drivers,
+                                       size);
+            return;
+#endif
+        default:
+            PointsAddRaceFuturesScalar(points, positions, number_of_drivers,
+                                       0, size);
+    }
+}
+
+/**
+ ***** Function: PointsRankFutures *****
+ * Description: ranks the drivers (or teams) of many interleaved futures of
+ * a season, the way the season orders its standings: more points first,
+ * then the better last race position, then the lower index. Every entry is
+ * compared with every other one, across a vector of futures at a time, so
+ * it is meant for rosters of real championships.
+ * @param backend - The backend to rank with.
+ * @param points - The points of the entries in every future, interleaved:
+ * element i*futures+f belongs to entry i in future f.
+ * @param positions - The last race positions of the entries (0 if there was
+ * no race yet), interleaved like the points.
+ * @param count - Number of entries.
+ * @param futures - Number of futures.
+ * @param ranks - Will hold the position of every entry in the standings of
+ * every future (1 is the leader), interleaved like the points.
+ */
+void PointsRankFutures(PointsBackend backend, const int* points,
+                       const int* positions, int count, int futures,
+                       int* ranks){
+    if (points==NULL || positions==NULL || ranks==NULL || count<=0 ||
+        futures<=0){
+        return;
+    }
+    switch (PointsSelectBackend(backend)){
+#ifdef POINTS_X86
+        case POINTS_BACKEND_AVX2:
+            PointsRankFuturesAvx2(points, positions, count, futures, ranks);
+            return;
+        case POINTS_BACKEND_AVX512:
+            PointsRankFuturesAvx512(points, positions, count, futures,
+                                    ranks);
+            return;
+#endif
+        default:
+            PointsRankFuturesScalar(points, positions, count, futures, 0,
+                                    ranks);
+    }
+}
+
+/** Static functions */
+/**
+ ***** Static Function : PointsBestBackend *****
+ * @return - The widest backend the machine supports.
+ */
+static PointsBackend PointsBestBackend(void){
+    if (PointsBackendIsSupported(POINTS_BACKEND_AVX512)){
+        return POINTS_BACKEND_AVX512;
+    }
+    if (PointsBackendIsSupported(POINTS_BACKEND_AVX2)){
+        return POINTS_BACKEND_AVX2;
+    }
+    return POINTS_BACKEND_SCALAR;
+}
+
+/**
+ ***** Static Function : PointsSelectBackend *****
+ * @param backend - A requested backend.
+ * @return - The backend to run: the widest supported one for the automatic
+ * backend, and the scalar one for an unsupported backend.
+ */
+static PointsBackend PointsSelectBackend(PointsBackend backend){
+    if (backend==POINTS_BACKEND_AUTO){
+        return PointsBestBackend();
+    }
+    if (!PointsBackendIsSupported(backend)){
+        return POINTS_BACKEND_SCALAR;
+    }
+    return backend;
+}
+
+/**
+ ***** Static Function : PointsAddRaceScalar *****
+ * Description: adds the points of the positions from 'first' on, one driver
+ * at a time. The vector backends use it for the positions after their last
+ * full vector.
+ * @param points - The points of the drivers.
+ * @param results - The ids of the drivers by their position in the race.
+ * @param number_of_drivers - Number of drivers in the race.
+ * @param first - Index of the first position to add.
+ */
+static void PointsAddRaceScalar(int* points, const int* results,
+                                int number_of_drivers, int first){
+    assert(points!=NULL && results!=NULL);
+    for (int i=first;i<number_of_drivers;i++){
+        points[results[i]-1] += number_of_drivers-(i+1);
+    }
+}
+
+/**
+ ***** Static Function : PointsAddRaceFuturesScalar *****
+ * Description: adds the points of a race to interleaved futures, one
+ * element at a time, from element 'first' on. The vector backends use it
+ * for the elements after their last full vector.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved positions.
+ * @param number_of_drivers - Number of drivers in the race.
+ * @param first - Index of the first element to add.
+ * @param size - Number of elements (drivers times futures).
+ */
+static void PointsAddRaceFuturesScalar(int* points, const int* positions,
+                                       int number_of_drivers, size_t first,
+                                       size_t size){
+    assert(points!=NULL && positions!=NULL);
+    for (size_t x=first;x<size;x++){
+        points[x] += number_of_drivers-positions[x];
+    }
+}
+
+/**
+ ***** Static Function : PointsRankFuturesScalar *****
+ * Description: ranks the entries of the futures from 'first' on, one
+ * future at a time. The vector backends use it for the futures after their
+ * last full vector.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved last race positions.
+ * @param count - Number of entries.
+ * @param futures - Number of futures.
+ * @param first - Index of the first future to rank.
+ * @param ranks - Will hold the interleaved ranks.
+ */
+static void PointsRankFuturesScalar(const int* points, const int* positions,
+                                    int count, int futures, int first,
+                                    int* ranks){
+    assert(points!=NULL && positions!=NULL && ranks!=NULL);
+    for (int f=first;f<futures;f++){
+        for (int i=0;i<count;i++){
+            int point = points[(size_t)i*futures+f];
+            int position = positions[(size_t)i*futures+f];
+            int rank = 1;
+            for (int j=0;j<count;j++){
+                int other_point = points[(size_t)j*futures+f];
+                int other_position = positions[(size_t)j*futures+f];
+                /* Counts the entries which come before entry i. */
+                rank += other_point>point ||
+                        (other_point==point &&
+                         (other_position<position ||
+                          (other_position==position && j<i)));
+            }
+            ranks[(size_t)i*futures+f] = rank;
+        }
+    }
+}
+
+#ifdef POINTS_X86
+/**
+ ***** Static Function : PointsAddRaceAvx2 *****
+ * Description: gathers the points of 8 drivers at a time and adds their
+ * race points. AVX2 has no scatter, so the sums are stored one by one.
+ * @param points - The points of the drivers.
+ * @param results - The ids of the drivers by their position in the race.
+ * @param number_of_drivers - Number of drivers in the race.
+ */
+__attribute__((target("avx2")))
+static void PointsAddRaceAvx2(int* points, const int* results,
+                              int number_of_drivers){
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    int i = 0;
+    for (;i+8<=number_of_drivers;i+=8){
+        __m256i ids = _mm256_loadu_si256((const __m256i*)(results+i));
+        __m256i indexes = _mm256_sub_epi32(ids, one);
+        /* Position i+1+lane gets number_of_drivers-(i+1+lane) points. */
+        __m256i race_points = _mm256_sub_epi32(
+                _mm256_set1_epi32(number_of_drivers-(i+1)), lanes);
+        __m256i sums = _mm256_add_epi32(
+                _mm256_i32gather_epi32(points, indexes, 4), race_points);
+        int stored[8], at[8];
+        _mm256_storeu_si256((__m256i*)stored, sums);
+        _mm256_storeu_si256((__m256i*)at, indexes);
+        for (int lane=0;lane<8;lane++){
+            points[at[lane]] = stored[lane];
+        }
+    }
+    PointsAddRaceScalar(points, results, number_of_drivers, i);
+}
+
+/**
+ ***** Static Function : PointsAddRaceAvx512 *****
+ * Description: gathers the points of 16 drivers at a time, adds their race
+ * points and scatters the sums back. The ids of a race are distinct, so
+ * the lanes of a scatter never collide.
+ * @param points - The points of the drivers.
+ * @param results - The ids of the drivers by their position in the race.
+ * @param number_of_drivers - Number of drivers in the race.
+ */
+__attribute__((target("avx512f")))
+static void PointsAddRaceAvx512(int* points, const int* results,
+                                int number_of_drivers){
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                            10, 11, 12, 13, 14, 15);
+    int i = 0;
+    for (;i+16<=number_of_drivers;i+=16){
+        __m512i ids = _mm512_loadu_si512((const void*)(results+i));
+        __m512i indexes = _mm512_sub_epi32(ids, one);
+        /* Position i+1+lane gets number_of_drivers-(i+1+lane) points. */
+        __m512i race_points = _mm512_sub_epi32(
+                _mm512_set1_epi32(number_of_drivers-(i+1)), lanes);
+        __m512i sums = _mm512_add_epi32(
+                _mm512_i32gather_epi32(indexes, (const void*)points, 4),
+                race_points);
+        _mm512_i32scatter_epi32((void*)points, indexes, sums, 4);
+    }
+    PointsAddRaceScalar(points, results, number_of_drivers, i);
+}
+
+/**
+ ***** Static Function : PointsAddRaceFuturesAvx2 *****
+ * Description: adds the points of a race to 8 interleaved elements at a
+ * time.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved positions.
+ * @param number_of_drivers - Number of drivers in the race.
+ * @param size - Number of elements (drivers times futures).
+ */
+__attribute__((target("avx2")))
+static void PointsAddRaceFuturesAvx2(int* points, const int* positions,
+                                     int number_of_drivers, size_t size){
+    const __m256i drivers = _mm256_set1_epi32(number_of_drivers);
+    size_t x = 0;
+    for (;x+8<=size;x+=8){
+        __m256i race_points = _mm256_sub_epi32(drivers,
+                _mm256_loadu_si256((const __m256i*)(positions+x)));
+        __m256i* sums = (__m256i*)(points+x);
+        _mm256_storeu_si256(sums, _mm256_add_epi32(
+                _mm256_loadu_si256(sums), race_points));
+    }
+    PointsAddRaceFuturesScalar(points, positions, number_of_drivers, x,
+                               size);
+}
+
+/**
+ ***** Static Function : PointsAddRaceFuturesAvx512 *****
+ * Description: adds the points of a race to 16 interleaved elements at a
+ * time.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved positions.
+ * @param number_of_drivers - Number of drivers in the race.
+ * @param size - Number of elements (drivers times futures).
+ */
+__attribute__((target("avx512f")))
+static void PointsAddRaceFuturesAvx512(int* points, const int* positions,
+                                       int number_of_drivers, size_t size){
+    const __m512i drivers = _mm512_set1_epi32(number_of_drivers);
+    size_t x = 0;
+    for (;x+16<=size;x+=16){
+        __m512i race_points = _mm512_sub_epi32(drivers,
+                _mm512_loadu_si512((const void*)(positions+x)));
+        _mm512_storeu_si512((void*)(points+x), _mm512_add_epi32(
+                _mm512_loadu_si512((const void*)(points+x)), race_points));
+    }
+    PointsAddRaceFuturesScalar(points, positions, number_of_drivers, x,
+                               size);
+}
+
+/**
+ ***** Static Function : PointsRankFuturesAvx2 *****
+ * Description: ranks the entries of 8 futures at a time. Entry j comes
+ * before entry i if it has more points, or as many points and a better
+ * position, or the same position and a lower index. The comparison masks
+ * are all ones (-1) where j comes first, so subtracting them counts.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved last race positions.
+ * @param count - Number of entries.
+ * @param futures - Number of futures.
+ * @param ranks - Will hold the interleaved ranks.
+ */
+__attribute__((target("avx2")))
+static void PointsRankFuturesAvx2(const int* points, const int* positions,
+                                  int count, int futures, int* ranks){
+    int f = 0;
+    for (;f+8<=futures;f+=8){
+        for (int i=0;i<count;i++){
+            size_t at = (size_t)i*futures+f;
+            __m256i point = _mm256_loadu_si256((const __m256i*)(points+at));
+            __m256i position =
+                    _mm256_loadu_si256((const __m256i*)(positions+at));
+            __m256i rank = _mm256_set1_epi32(1);
+            for (int j=0;j<count;j++){
+                size_t other = (size_t)j*futures+f;
+                __m256i other_point =
+                        _mm256_loadu_si256((const __m256i*)(points+other));
+                __m256i other_position =
+                        _mm256_loadu_si256((const __m256i*)(positions+other));
+                /* With a lower index an equal position comes first too. */
+                __m256i better_position = (j<i) ?
+                        _mm256_cmpgt_epi32(_mm256_add_epi32(position,
+                                _mm256_set1_epi32(1)), other_position) :
+                        _mm256_cmpgt_epi32(position, other_position);
+                __m256i first = _mm256_or_si256(
+                        _mm256_cmpgt_epi32(other_point, point),
+                        _mm256_and_si256(
+                                _mm256_cmpeq_epi32(other_point, point),
+                                better_position));
+                rank = _mm256_sub_epi32(rank, first);
+            }
+            _mm256_storeu_si256((__m256i*)(ranks+at), rank);
+        }
+    }
+    /* The tail is a sibling call, before which the compiler doesn't clear
+     * the upper halves of the vector registers; left dirty, they slow every
+     * SSE instruction of the caller (such as those of the libm). */
+    _mm256_zeroupper();
+    PointsRankFuturesScalar(points, positions, count, futures, f, ranks);
+}
+
+/**
+ ***** Static Function : PointsRankFuturesAvx512 *****
+ * Description: ranks the entries of 16 futures at a time, like the AVX2
+ * backend but with comparison masks.
+ * @param points - The interleaved points.
+ * @param positions - The interleaved last race positions.
+ * @param count - Number of entries.
+ * @param futures - Number of futures.
+ * @param ranks - Will hold the interleaved ranks.
+ */
+__attribute__((target("avx512f")))
+static void PointsRankFuturesAvx512(const int* points, const int* positions,
+                                    int count, int futures, int* ranks){
+    const __m512i one = _mm512_set1_epi32(1);
+    int f = 0;
+    for (;f+16<=futures;f+=16){
+        for (int i=0;i<count;i++){
+            size_t at = (size_t)i*futures+f;
+            __m512i point = _mm512_loadu_si512((const void*)(points+at));
+            __m512i position =
+                    _mm512_loadu_si512((const void*)(positions+at));
+            __m512i rank = one;
+            for (int j=0;j<count;j++){
+                size_t other = (size_t)j*futures+f;
+                __m512i other_point =
+                        _mm512_loadu_si512((const void*)(points+other));
+                __m512i other_position =
+                        _mm512_loadu_si512((const void*)(positions+other));
+                /* With a lower index an equal position comes first too. */
+                __mmask16 better_position = (j<i) ?
+                        _mm512_cmple_epi32_mask(other_position, position) :
+                        _mm512_cmplt_epi32_mask(other_position, position);
+                __mmask16 first =
+                        _mm512_cmpgt_epi32_mask(other_point, point) |
+                        (_mm512_cmpeq_epi32_mask(other_point, point) &
+                         better_position);
+                rank = _mm512_mask_add_epi32(rank, first, rank, one);
+            }
+            _mm512_storeu_si512((void*)(ranks+at), rank);
+        }
+    }
+    _mm256_zeroupper(); // As in PointsRankFuturesAvx2.
+    PointsRankFuturesScalar(points, positions, count, futures, f, ranks);
+}
+#endif
+/** End of static functions */
@@ -0,0 +1,26 @@
+/*
+ * points.h
+ */
+
+#ifndef POINTS_H_
+#define POINTS_H_
+
+#include <stdbool.h>
+
+typedef enum pointsBackend {
+    POINTS_BACKEND_AUTO,
+    POINTS_BACKEND_SCALAR,
+    POINTS_BACKEND_AVX2,
+    POINTS_BACKEND_AVX512} PointsBackend;
+
+bool PointsBackendIsSupported(PointsBackend backend);
+void PointsAddRace(PointsBackend backend, int* points, const int* results,
+                   int number_of_drivers);
+void PointsAddRaceFutures(PointsBackend backend, int* points,
+                          const int* positions, int number_of_drivers,
+                          int futures);
+void PointsRankFutures(PointsBackend backend, const int* points,
+                       const int* positions, int count, int futures,
+                       int* ranks);
+
+#endif /* POINTS_H_ */
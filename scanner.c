@@ -0,0 +1,216 @@
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include "scanner.h"
+
+/* The vector backends are built for x86 with GCC or Clang, which can compile
+ * a function for an instruction set the whole program isn't built for. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCANNER_X86
+#include <immintrin.h>
+#endif
+
+/* The vector backends look for newlines 64 bytes at a time, one bit of a
+ * mask per byte. */
+#define SCANNER_BLOCK_SIZE 64
+
+/** Declarations */
+static ScannerBackend ScannerBestBackend(void);
+static size_t ScannerFindNewlinesScalar(const char* data, size_t length,
+                                        size_t offset, size_t* newlines,
+                                        size_t capacity, size_t found);
+#ifdef SCANNER_X86
+static inline size_t ScannerAddBlockNewlines(uint64_t mask, size_t block,
+                                             size_t* newlines,
+                                             size_t capacity, size_t found);
+static size_t ScannerFindNewlinesSse2(const char* data, size_t length,
+                                      size_t* newlines, size_t capacity);
+static size_t ScannerFindNewlinesAvx2(const char* data, size_t length,
+                                      size_t* newlines, size_t capacity);
+#endif
+/** End of declarations */
+
+/**
+ ***** Function: ScannerBackendIsSupported *****
+ * Description: checks if a backend can run on this machine.
+ * @param backend - A scanner backend.
+ * @return - True if the backend can be used, else false. The automatic and
+ * scalar backends are always supported.
+ */
+bool ScannerBackendIsSupported(ScannerBackend backend){
+    switch (backend){
+        case SCANNER_BACKEND_AUTO:
+        case SCANNER_BACKEND_SCALAR:
+            return true;
+#ifdef SCANNER_X86
+        case SCANNER_BACKEND_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case SCANNER_BACKEND_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ ***** Function: ScannerFindNewlines *****
+ * Description: finds the offsets of the first newlines of a buffer. The
+ * automatic backend picks the widest backend the machine supports, and an
+ * unsupported backend falls back to the scalar one.
+ * @param backend - The backend to scan with.
+ * @param data - The buffer (it doesn't have to end with '\0').
+ * @param length - Length of the buffer.
+ * @param newlines - Gets the offsets of the newlines, in increasing order.
+ * @param capacity - The maximal number of offsets to find.
+ * @return - The number of offsets found. If it is 'capacity' there may be
+ * more newlines after the last one found.
+ */
+size_t ScannerFindNewlines(ScannerBackend backend, const char* data,
+                           size_t length, size_t* newlines, size_t capacity){
+    if (data==NULL || newlines==NULL){
+        return 0;
+    }
+    if (backend==SCANNER_BACKEND_AUTO){
+        backend = ScannerBestBackend();
+    }
+    else if (!ScannerBackendIsSupported(backend)){
+        backend = SCANNER_BACKEND_SCALAR;
+    }
+    switch (backend){
+#ifdef SCANNER_X86
+        case SCANNER_BACKEND_SSE2:
+            return ScannerFindNewlinesSse2(data, length, newlines, capacity);
+        case SCANNER_BACKEND_AVX2:
+            return ScannerFindNewlinesAvx2(data, length, newlines, capacity);
+#endif
+        default:
+            return ScannerFindNewlinesScalar(data, length, 0, newlines,
+                                             capacity, 0);
+    }
+}
+
+/** Static functions */
+/**
+ ***** Static Function : ScannerBestBackend *****
+ * @return - The widest backend the machine supports.
+ */
+static ScannerBackend ScannerBestBackend(void){
+    if (ScannerBackendIsSupported(SCANNER_BACKEND_AVX2)){
+        return SCANNER_BACKEND_AVX2;
+    }
+    if (ScannerBackendIsSupported(SCANNER_BACKEND_SSE2)){
+        return SCANNER_BACKEND_SSE2;
+    }
+    return SCANNER_BACKEND_SCALAR;
+}
+
+/**
+ ***** Static Function : ScannerFindNewlinesScalar *****
+ * Description: finds newlines with memchr. The vector backends use it for
+ * the bytes after their last full block.
+ * @param data - The buffer.
+ * @param length - Length of the buffer.
+ * @param offset - Where to start looking.
+ * @param newlines - Gets the offsets of the newlines.
+ * @param capacity - The maximal number of offsets.
+ * @param found - The number of offsets already found.
+ * @return - The number of offsets found, including the ones found before.
+ */
+static size_t ScannerFindNewlinesScalar(const char* data, size_t length,
+                                        size_t offset, size_t* newlines,
+                                        size_t capacity, size_t found){
+    assert(data!=NULL && newlines!=NULL && offset<=length);
+    const char* newline;
+    while (found<capacity &&
+           (newline = memchr(data+offset, '\n', length-offset))!=NULL){
+        newlines[found++] = (size_t)(newline-data);
+        offset = (size_t)(newline-data)+1;
+    }
+    return found;
+}
+
+#ifdef SCANNER_X86
+/**
+ ***** Static Function : ScannerAddBlockNewlines *****
+ * Description: turns the newlines mask of a block into offsets.
+ * @param mask - Bit i is set if byte i of the block is a newline.
+ * @param block - Offset of the block.
+ * @param newlines - Gets the offsets of the newlines.
+ * @param capacity - The maximal number of offsets.
+ * @param found - The number of offsets already found.
+ * @return - The number of offsets found, including the ones found before.
+ */
+static inline size_t ScannerAddBlockNewlines(uint64_t mask, size_t block,
+                                             size_t* newlines,
+                                             size_t capacity, size_t found){
+    while (mask!=0 && found<capacity){
+        newlines[found++] = block+(size_t)__builtin_ctzll(mask);
+        mask &= mask-1; // Clears the lowest newline.
+    }
+    return found;
+}
+
+/**
+ ***** Static Function : ScannerFindNewlinesSse2 *****
+ * Description: finds newlines 16 bytes per comparison.
+ * @param data - The buffer.
+ * @param length - Length of the buffer.
+ * @param newlines - Gets the offsets of the newlines.
+ * @param capacity - The maximal number of offsets.
+ * @return - The number of offsets found.
+ */
+__attribute__((target("sse2")))
+static size_t ScannerFindNewlinesSse2(const char* data, size_t length,
+                                      size_t* newlines, size_t capacity){
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t found = 0;
+    size_t block = 0;
+    for (;block+SCANNER_BLOCK_SIZE<=length && found<capacity;
+         block+=SCANNER_BLOCK_SIZE){
+        uint64_t mask = 0;
+        for (int part=0;part<SCANNER_BLOCK_SIZE/16;part++){
+            __m128i bytes =
+                    _mm_loadu_si128((const __m128i*)(data+block+part*16));
+            uint64_t part_mask = (uint16_t)_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(bytes, newline));
+            mask |= part_mask<<(part*16);
+        }
+        found = ScannerAddBlockNewlines(mask, block, newlines, capacity,
+                                        found);
+    }
+    return ScannerFindNewlinesScalar(data, length, block, newlines, capacity,
+                                     found);
+}
+
+/**
+ ***** Static Function : ScannerFindNewlinesAvx2 *****
+ * Description: finds newlines 32 bytes per comparison.
+ * @param data - The buffer.
+ * @param length - Length of the buffer.
+ * @param newlines - Gets the offsets of the newlines.
+ * @param capacity - The maximal number of offsets.
+ * @return - The number of offsets found.
+ */
+__attribute__((target("avx2")))
+static size_t ScannerFindNewlinesAvx2(const char* data, size_t length,
+                                      size_t* newlines, size_t capacity){
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t found = 0;
+    size_t block = 0;
+    for (;block+SCANNER_BLOCK_SIZE<=length && found<capacity;
+         block+=SCANNER_BLOCK_SIZE){
+        __m256i low = _mm256_loadu_si256((const __m256i*)(data+block));
+        __m256i high = _mm256_loadu_si256((const __m256i*)(data+block+32));
+        uint64_t low_mask = (uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(low, newline));
+        uint64_t high_mask = (uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(high, newline));
+        found = ScannerAddBlockNewlines(low_mask|high_mask<<32, block,
+                                        newlines, capacity, found);
+    }
+    return ScannerFindNewlinesScalar(data, length, block, newlines, capacity,
+                                     found);
+}
+#endif
+/** End of static functions */
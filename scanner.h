@@ -0,0 +1,21 @@
+/*
+ * scanner.h
+ */
+
+#ifndef SCANNER_H_
+#define SCANNER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum scannerBackend {
+    SCANNER_BACKEND_AUTO,
+    SCANNER_BACKEND_SCALAR,
+    SCANNER_BACKEND_SSE2,
+    SCANNER_BACKEND_AVX2} ScannerBackend;
+
+bool ScannerBackendIsSupported(ScannerBackend backend);
+size_t ScannerFindNewlines(ScannerBackend backend, const char* data,
+                           size_t length, size_t* newlines, size_t capacity);
+
+#endif /* SCANNER_H_ */
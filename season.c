@@ -4,39 +4,305 @@
 #include <assert.h>
 #include <stdbool.h>
 #include "season.h"
+#include "season_internal.h"
+#include "scanner.h"
+#include "points.h"
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+/* The radix backend sorts the points one byte per pass. It is chosen
+ * automatically when the points range fits in RADIX_AUTO_MAX_PASSES bytes. */
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1<<RADIX_BITS)
+#define RADIX_AUTO_MAX_PASSES 3
+/* Standings of at most this many drivers (or teams) are sorted by a sorting
+ * network, automatically or when the network backend is selected. */
+#define NETWORK_MAX_KEYS 32
 
+#define ROSTER_INITIAL_CAPACITY 16
+/* Each reader slot has a cache line of its own, so readers on different
+ * cores don't invalidate each other's lines. */
+#define READER_SLOT_SIZE 64
+
+/* Everything in the block of a season is aligned to this many bytes. */
+#define SEASON_BLOCK_ALIGNMENT 16
+
+/* The first block of a names arena that grows block by block. */
+#define NAME_ARENA_BLOCK_SIZE 4096
+/* The number of line ends the roster parser asks the scanner for at once. */
+#define ROSTER_SCAN_BATCH 256
+
+/* Snapshots are written in the byte order of the machine. A snapshot with a
+ * different magic or version is rejected. */
+#define SNAPSHOT_MAGIC "F1SN"
+#define SNAPSHOT_VERSION 1
+
+typedef struct standingsKey StandingsKey;
+typedef struct rosterParser RosterParser;
+typedef struct nameBlock NameBlock;
+typedef struct nameArena NameArena;
+typedef struct snapshotHeader SnapshotHeader;
+typedef struct snapshotLayout SnapshotLayout;
+typedef struct readerSlot ReaderSlot;
+typedef struct concurrentReads ConcurrentReads;
+typedef struct sharedNames SharedNames;
 
 /** Declarations */
-static void DriversAndTeamsCounter(int* drivers, int* teams,
-                                   const char* details,SeasonStatus* status);
-static bool DriverIsNone(char* name, char* source );
-static void DriversArrayToPointsArray(int *drivers_points,
-                                      Driver *drivers_array, int number_of_drivers);
-static int FindIndexOfMaxPointsDriver(Season season,
-                                      int* points, int number_of_drivers);
+static void DriversArrayToStandingsKeys(Season season,
+                                       StandingsKey* keys);
+static void TeamsArrayToStandingsKeys(Season season, StandingsKey* keys);
+static int CompareStandingsKeys(const void* first, const void* second);
+static void SelectTopStandingsKeys(StandingsKey* keys, int count, int k);
+static void SiftDownStandingsKey(StandingsKey* heap, int size, int index);
 static int FindLastPositionById(Season season, int id);
-static int FindIndexOfMaxPointsTeam(Season season, int *points,
-                                    int number_of_teams);
-static int FindBestTeamDriverPosition (Season season,Team team);
-static Driver* DriverArrayAllocation(Season season,Team* teams_array);
-static Team* TeamArrayAllocation(Season season);
+static int FindBestTeamDriverPosition (Season season,int team_index);
+static bool StandingsCacheAllocation(Season season);
+static void RankDrivers(Season season);
+static void DriversRankingCache(Season season);
+static void ComparisonSortDrivers(Season season, int* order);
+static bool RadixSortDrivers(Season season, int* order, bool force);
+static bool UseSortingNetwork(Season season, int count);
+static void NetworkSortDrivers(Season season, int* order);
+static void NetworkSortStandingsKeys(StandingsKey* keys, int count);
+static uint64_t PackStandingsKey(const StandingsKey* key);
+static void UnpackStandingsKey(uint64_t packed, StandingsKey* key);
+static Team* TeamsStandingsCache(Season season);
+static void SortTeamsByPoints(Season season, Team* sorted_team_array);
+static bool MapDriversToTeams(Season season);
+static bool DriversPointsAllocation(Season season);
 static int* SeasonLastRaceResultsArrayAllocation(Season season);
-static void SetDriversInSeason(char* driver_name, Driver* drivers_array,
-                                     Team* team_array, int* id,DriverStatus* status, int* driver_index,
-                                     int* team_index, Season season, char* season_info_copy);
-static void SeasonDriversAndTeamsCreation (const char* season_info,
-                                           SeasonStatus* status,Season season);
+static Season SeasonAllocation(void);
+static void SeasonInitialize(Season season);
+static Season SeasonBlockAllocation(int teams, int drivers,
+                                    size_t names_size);
+static size_t SeasonBlockSize(int teams, int drivers, size_t names_size);
+static size_t SeasonBlockRound(size_t size);
+static void* SeasonAllocate(Season season, size_t size);
+static Team SeasonCreateTeam(Season season, char* name);
+static Driver SeasonCreateDriver(Season season, char* name, int id);
+static Season SeasonCreateFromRoster(const char* season_info, size_t length);
+static size_t SeasonCountLines(const char* season_info, size_t length);
+static bool SeasonParseRoster(RosterParser* parser, const char* season_info,
+                              size_t length);
+static bool SeasonFinishCreation(Season season);
+static bool SeasonRaceStateAllocation(Season season);
+static bool SeasonCloneRoster(Season clone, Season season);
+static SharedNames* SeasonShareNames(Season season);
+static SharedNames* SharedNamesCreate(Season season);
+static void SharedNamesRelease(SharedNames* shared);
+static bool RosterParserAddLine(RosterParser* parser, const char* line,
+                                size_t length);
+static bool NameArenaReserve(NameArena* arena, size_t size);
+static char* NameArenaAllocate(NameArena* arena, size_t size);
+static char* NameArenaCopy(NameArena* arena, const char* name,
+                           size_t length);
+static void NameArenaDestroy(NameArena* arena);
+static const char* RosterParserAddLines(RosterParser* parser,
+                                        const char* data, size_t length);
+static bool SeasonParserKeepPending(SeasonParser parser, const char* data,
+                                    size_t length);
+static void SeasonSetLastRace(Season season, const int* results);
+static bool RaceResultsAreValid(Season season, const int* results,
+                                int* seen, int stamp);
+static void SnapshotLayoutCompute(SnapshotLayout* layout, int teams,
+                                  int drivers, uint64_t names_size);
+static bool SnapshotWriteNames(FILE* file, Season season);
+static bool SnapshotPad(FILE* file, size_t offset);
+static Season SeasonRestoreSnapshot(const char* data, size_t size,
+                                    SeasonStatus* status);
+static SeasonStatus SeasonRestoreRoster(Season season, const char* data,
+                                        const SnapshotHeader* header,
+                                        const SnapshotLayout* layout);
+static SeasonStandings StandingsTake(Season season);
+static void StandingsFill(Season season, SeasonStandings standings);
+static void StandingsPublish(Season season, SeasonStandings standings);
+static void StandingsReclaim(ConcurrentReads* reads);
+static void StandingsListDestroy(SeasonStandings standings);
+static void ConcurrentReadsDestroy(ConcurrentReads* reads);
+static bool ArrayReserve(void** array, int* capacity, int needed,
+                         size_t element_size);
+static int ParseYear(const char* line, size_t length);
+static bool LineIsNone(const char* line, size_t length);
 /** End of declarations*/
 
+/* A standings key packs everything the standings order depends on, so the
+ * drivers (or the teams) can be sorted with a single comparison function. */
+struct standingsKey {
+    int points;
+    int last_position; // 0 if there was no race yet.
+    int index; // Index in the season's drivers (or teams) array.
+};
+
+/* A block of names. A block never moves, so the teams and drivers of the
+ * season point into it. */
+struct nameBlock {
+    NameBlock* next;
+    char names[];
+};
+
+/* The names of the teams and drivers of a season, packed one after the
+ * other in a few blocks which are freed together with the season. */
+struct nameArena {
+    NameBlock* blocks; // The newest block first.
+    char* end; // Where the next name will be copied to.
+    size_t left; // Free bytes in the newest block.
+    size_t next_block_size; // Minimal size of the next block.
+};
+
+/* The state of the roster parser between two lines of the season info. */
+struct rosterParser {
+    Season season;
+    int line_number; // Lines after the year line, -1 before the year line.
+    int teams_capacity;
+    int drivers_capacity;
+};
+
+/* A push parser: the season info arrives in chunks, and only the line that
+ * is cut by the end of a chunk is buffered. */
+struct seasonParser {
+    RosterParser roster;
+    bool failed; // True after a memory allocation error.
+    char* pending; // The start of a line whose end did not arrive yet.
+    size_t pending_length;
+    size_t pending_capacity;
+};
+
+/* A snapshot starts with this header, followed by the sections described
+ * by SnapshotLayout. */
+struct snapshotHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t year;
+    int32_t number_of_teams;
+    int32_t number_of_drivers;
+    int32_t reserved;
+    uint64_t names_size;
+};
+
+/* The offsets of the sections of a snapshot, each aligned to 8 bytes:
+ * uint64_t teams_names[t], uint64_t drivers_names[n] (offsets of the names
+ * in the names section), int32_t drivers_points[n], int32_t drivers_teams[n],
+ * int32_t last_race_results[n] and the names, each ending with '\0'. */
+struct snapshotLayout {
+    size_t teams_names;
+    size_t drivers_names;
+    size_t drivers_points;
+    size_t drivers_teams;
+    size_t last_race_results;
+    size_t names;
+    size_t size;
+};
+
+/* An immutable copy of the standings, published by the writer after each
+ * race and read by any number of readers. */
+struct seasonStandings {
+    int number_of_drivers;
+    int number_of_teams;
+    Driver* drivers; // drivers[p-1] is the driver in position p.
+    int* drivers_points; // drivers_points[p-1] are its points.
+    int* drivers_ranks; // drivers_ranks[id-1] is the position of driver id.
+    Team* teams; // teams[p-1] is the team in position p.
+    int* teams_points; // teams_points[p-1] are its points.
+    /* The epoch in which the standings stopped being the current ones. They
+     * are freed once no reader is in an older epoch. */
+    uint64_t retire_epoch;
+    SeasonStandings next; // The next standings in a retired or free list.
+};
+
+/* The epoch of a reader, 0 while it isn't reading. */
+struct readerSlot {
+    uint64_t epoch;
+    int in_use;
+    char padding[READER_SLOT_SIZE-sizeof(uint64_t)-sizeof(int)];
+};
+
+/* The state shared between the writer and the readers of a season. Only
+ * 'current', 'epoch' and the slots are touched by the readers, always
+ * through atomic operations. */
+struct concurrentReads {
+    SeasonStandings current;
+    uint64_t epoch; // Incremented by every publication, starts at 1.
+    ReaderSlot* slots;
+    int max_readers;
+    SeasonStandings retired; // Replaced standings readers may still hold.
+    SeasonStandings free; // Standings no reader holds, ready for reuse.
+};
+
+struct seasonReader {
+    ConcurrentReads* reads;
+    ReaderSlot* slot;
+};
+
 struct season {
+    NameArena names; // All the team and driver names.
     int year;
     int number_of_teams;
     Team* team_array;
     int number_of_drivers;
     Driver* drivers_array;
+    /* The state of the drivers is kept in parallel arrays, indexed like
+     * drivers_array (the id of driver i is i+1), so that the standings are
+     * computed by streaming over them. drivers_points[i] is the number of
+     * points of driver i, which the driver itself reads and updates. */
+    int* drivers_points;
     int* last_race_results_array;
+    /* The inverse of last_race_results_array: last_race_positions[id-1] is
+     * the position of the driver 'id' in the last race (0 if there was no
+     * race yet). */
+    int* last_race_positions;
+    /* The drivers ranking is updated by every race result:
+     * drivers_standings[p-1] is the driver in position p and
+     * drivers_ranks[i] is the position of driver i. A change of points made
+     * through a driver only marks it stale, and the next query of the
+     * ranking updates it. */
+    Driver* drivers_standings;
+    int* drivers_ranks;
+    bool drivers_ranking_stale;
+    /* Incremented by every race result. The cached teams standings are
+     * valid only while their generation equals results_generation. */
+    int results_generation;
+    Team* teams_standings;
+    int teams_standings_generation;
+    StandingsKey* standings_keys; // Scratch space for sorting.
+    StandingsBackend standings_backend;
+    int* sort_scratch; // Scratch space for the radix sort (2 per driver).
+    /* Team totals are accumulated by every race result: teams_points[j] is
+     * the number of points of team j. drivers_teams[i] is the index of the
+     * team of driver i (-1 if the driver has no team), and
+     * teams_drivers[2*j] and teams_drivers[2*j+1] are the indexes of the
+     * first and second drivers of team j (-1 for an empty seat). */
+    int* teams_points;
+    int* drivers_teams;
+    int* teams_drivers;
+    /* teams_best_positions[j] is the best position of the drivers of team j
+     * in the last race, the tie-break of the teams standings. It is
+     * computed once per race. */
+    int* teams_best_positions;
+    /* A season created from a whole season info lives in a single block,
+     * which starts with the season itself. Its arrays, teams, drivers and
+     * names are taken from the rest of the block in creation order. */
+    char* block_end; // The free part of the block, NULL without a block.
+    size_t block_left;
+    ConcurrentReads* reads; // NULL until concurrent reads are enabled.
+    /* The names shared with the clones of the season, NULL before the
+     * first clone. The teams and drivers of a clone point into them. */
+    SharedNames* shared_names;
+};
+
+/* A copy of the names of the teams and drivers of a season, made when the
+ * season is first cloned. It is freed with the last season using it, so a
+ * destroyed season frees all of its own memory even while clones are
+ * alive. */
+struct sharedNames {
+    int references; // Seasons using the names, updated atomically.
+    /* The names of the teams, then of the drivers, in the order of the
+     * season's arrays. The characters follow the array. */
+    char* names[];
 };
 
 /**
@@ -47,23 +313,89 @@ struct season {
  * @return - Success/fail +reason of the function.
  */
 SeasonStatus SeasonAddRaceResult(Season season, int* results){
-    if (season==NULL || results==NULL){
+    return SeasonAddRaceResults(season, results, 1);
+}
+
+/**
+ ***** Function: SeasonAddRaceResults *****
+ * Description: adds the results of several races at once. The whole batch is
+ * checked before any of it is applied, the points of the races are summed
+ * per driver and the drivers are ranked once, after the last race.
+ * @param season - A pointer to a season.
+ * @param results_matrix - The results of the races one after the other, each
+ * holding the ids of all the drivers by their position in the race.
+ * @param races - Number of races.
+ * @return - Success/fail +reason of the function. In case of
+ * BAD_RACE_RESULTS (a race that isn't a permutation of the ids) no race is
+ * added.
+ */
+SeasonStatus SeasonAddRaceResults(Season season, const int* results_matrix,
+                                  int races){
+    if (season==NULL || results_matrix==NULL){
         return SEASON_NULL_PTR;
     }
-    for (int i=0;i<SeasonGetNumberOfDrivers(season);i++) {
-        /* Add points to each driver by it's id and position in race. */
-        DriverAddRaceResult(season->drivers_array[results[i]-1],i+1);
-        /* Copies the last race results. */
-        season->last_race_results_array[i] = results[i];
+    if (races<0){
+        return BAD_RACE_RESULTS;
+    }
+    if (races==0){
+        return SEASON_OK;
+    }
+    int number_of_drivers = season->number_of_drivers;
+    /* The scratch space is free between rankings: the first part marks the
+     * ids seen in each race, the second sums the points of each driver. */
+    int* seen = season->sort_scratch;
+    int* points = season->sort_scratch+number_of_drivers;
+    memset(seen, 0, sizeof(*seen)*(size_t)number_of_drivers);
+    for (int race=0;race<races;race++){
+        const int* results = results_matrix+(size_t)race*number_of_drivers;
+        if (!RaceResultsAreValid(season, results, seen, race+1)){
+            return BAD_RACE_RESULTS;
+        }
+    }
+    /* The standings the readers will see are taken before anything
+     * changes, so a memory allocation error leaves the season as it was. */
+    SeasonStandings standings = NULL;
+    if (season->reads!=NULL){
+        standings = StandingsTake(season);
+        if (standings==NULL){
+            return SEASON_MEMORY_ERROR;
+        }
+    }
+    memset(points, 0, sizeof(*points)*(size_t)number_of_drivers);
+    for (int race=0;race<races;race++){
+        PointsAddRace(POINTS_BACKEND_AUTO, points,
+                      results_matrix+(size_t)race*number_of_drivers,
+                      number_of_drivers);
+    }
+    for (int i=0;i<number_of_drivers;i++){
+        season->drivers_points[i] += points[i];
+        /* Add the same points to the driver's team. */
+        int team_index = season->drivers_teams[i];
+        if (team_index>=0){
+            season->teams_points[team_index] += points[i];
+        }
+    }
+    SeasonSetLastRace(season,
+                      results_matrix+(size_t)(races-1)*number_of_drivers);
+    RankDrivers(season);
+    /* Invalidates the cached teams standings. */
+    season->results_generation++;
+    if (standings!=NULL){
+        StandingsFill(season, standings);
+        StandingsPublish(season, standings);
     }
     return SEASON_OK;
 }
 
 /**
  ***** Function: SeasonGetDriversStandings*****
- * Description: sorts the drivers by their position according to the points gained till the function is called.
+ * Description: sorts the drivers by their position according to the points
+ * gained till the function is called. Drivers with an equal number of points
+ * are ordered by their position in the last race.
+ * The ranking is maintained by SeasonAddRaceResult, so this only copies it.
  * @param season - a pointer to a season.
- * @return - Success/failure of the function (if fails - with cause).
+ * @return - A new array of the drivers sorted by position (the caller has to
+ * free it) or NULL in case of failure.
  */
 Driver* SeasonGetDriversStandings(Season season){
     if (season==NULL){
@@ -74,29 +406,44 @@ Driver* SeasonGetDriversStandings(Season season){
     if(drivers_standings == NULL){
         return NULL;
     }
-    int* drivers_points_array =
-            malloc(sizeof(*drivers_points_array)*season->number_of_drivers);
-    if(drivers_points_array == NULL){
-        free(drivers_standings);
-        return NULL;
+    SeasonGetDriversStandingsInto(season, drivers_standings,
+                                  season->number_of_drivers, NULL);
+    return drivers_standings;
+}
+
+/**
+ ***** Function: SeasonGetDriversStandingsInto *****
+ * Description: writes the drivers standings into a buffer owned by the
+ * caller. Does not allocate memory.
+ * @param season - A pointer to a season.
+ * @param drivers_standings - A buffer which will hold the drivers sorted by
+ * position.
+ * @param capacity - Number of drivers the buffer can hold.
+ * @param status - Will hold success or failure.
+ * @return - Number of drivers written, or the number of drivers needed if
+ * the buffer is too small.
+ */
+int SeasonGetDriversStandingsInto(Season season, Driver* drivers_standings,
+                                  int capacity, SeasonStatus* status){
+    if (season==NULL || drivers_standings==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return 0;
     }
-    /* drivers_points_array will hold the points of the drivers.
-     * drivers_points_array[i] will contain the number of points of
-     * the driver i.  */
-    DriversArrayToPointsArray(drivers_points_array,
-                              season->drivers_array, season->number_of_drivers);
-    /* Sorting the drivers by points. The driver with the highest score
-     * will be stored at driver_standings[0], and so on.*/
-    int driver_index;
-    for(int i=0;i<season->number_of_drivers;i++){
-        /* driver_index is holding the index of the driver who
-         * has the greatest score. */
-        driver_index = FindIndexOfMaxPointsDriver
-                (season,drivers_points_array,season->number_of_drivers);
-        drivers_standings[i] = season->drivers_array[driver_index];
+    if (capacity<season->number_of_drivers){
+        if(status!=NULL){
+            *status=SEASON_BUFFER_TOO_SMALL;
+        }
+        return season->number_of_drivers;
     }
-    free(drivers_points_array);
-    return drivers_standings;
+    DriversRankingCache(season);
+    memcpy(drivers_standings, season->drivers_standings,
+           sizeof(*drivers_standings)*season->number_of_drivers);
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    return season->number_of_drivers;
 }
 
 /**
@@ -104,6 +451,10 @@ Driver* SeasonGetDriversStandings(Season season){
  * Description: creates a new season.
  * @param status - Success/failure of the function (if fails - with cause).
  * @param season_info - String containing input of teams and drivers.
+ * The string is parsed once. The season, its arrays, teams, drivers and
+ * names are allocated in a single block, sized before parsing from the
+ * number of lines of the string (a quick newline scan), and only the names
+ * are copied into it.
  * @return - A pointer to the season.
  */
 Season SeasonCreate (SeasonStatus* status,const char* season_info){
@@ -113,568 +464,2615 @@ Season SeasonCreate (SeasonStatus* status,const char* season_info){
         }
         return NULL;
     }
-    SeasonStatus season_allocation_status;
-    Season new_season = malloc(sizeof(*new_season));
+    Season new_season = SeasonCreateFromRoster(season_info,
+                                               strlen(season_info));
     if(new_season == NULL){
         if(status!=NULL) {
             *status = SEASON_MEMORY_ERROR;
         }
         return NULL;
     }
-    /* Counts the number of teams and drivers in the season */
-    DriversAndTeamsCounter(&new_season->number_of_drivers,
-                           &new_season->number_of_teams,season_info,&season_allocation_status);
-    if ((season_allocation_status==SEASON_MEMORY_ERROR )){
-        if (status!=NULL){
-            *status=season_allocation_status;
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    return new_season;
+}
+
+/**
+ ***** Function: SeasonCreateFromFile *****
+ * Description: creates a new season from a file in the format of
+ * SeasonCreate's season info. The file is memory mapped and parsed in
+ * place, so only the names are copied.
+ * @param status - SEASON_OK in case of success, BAD_SEASON_INFO if path is
+ * NULL, SEASON_FILE_ERROR if the file is missing or can't be read or
+ * mapped, or SEASON_MEMORY_ERROR.
+ * @param path - Path of the season info file.
+ * @return - A pointer to the season.
+ */
+Season SeasonCreateFromFile(SeasonStatus* status, const char* path){
+    if (path==NULL){
+        if(status!=NULL){
+            *status=BAD_SEASON_INFO;
         }
-        free(new_season);
         return NULL;
     }
-    new_season->team_array = TeamArrayAllocation(new_season);
-    /* If allocation fails frees all the allocated elements. */
-    if (new_season->team_array == NULL){
-        if (status!=NULL){
-            *status=SEASON_MEMORY_ERROR;
+    int file = open(path, O_RDONLY);
+    struct stat file_stat;
+    if (file<0 || fstat(file, &file_stat)<0){
+        if (file>=0){
+            close(file);
+        }
+        if(status!=NULL){
+            *status=SEASON_FILE_ERROR;
         }
         return NULL;
     }
-    new_season->drivers_array = DriverArrayAllocation
-            (new_season,new_season->team_array);
-    if (new_season->drivers_array == NULL){
-        if (status!=NULL){
-            *status=SEASON_MEMORY_ERROR;
+    size_t length = (size_t)file_stat.st_size;
+    /* An empty file can't be mapped, it is parsed as an empty string. */
+    const char* season_info = "";
+    void* map = NULL;
+    if (length>0){
+        map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+        if (map==MAP_FAILED){
+            close(file);
+            if(status!=NULL){
+                *status=SEASON_FILE_ERROR;
+            }
+            return NULL;
         }
-        return NULL;
+        madvise(map, length, MADV_SEQUENTIAL);
+        season_info = map;
     }
-    /* If we got here we can create teams and drivers */
-    SeasonDriversAndTeamsCreation(season_info,
-                                  &season_allocation_status,new_season);
-            if(season_allocation_status==SEASON_MEMORY_ERROR){
-                return NULL;
+    close(file); // The mapping stays valid after the file is closed.
+    Season new_season = SeasonCreateFromRoster(season_info, length);
+    if (map!=NULL){
+        munmap(map, length);
     }
-    new_season->last_race_results_array =
-            SeasonLastRaceResultsArrayAllocation(new_season);
-    if(new_season->last_race_results_array == NULL) {
-        SeasonDestroy(new_season);
+    if (new_season==NULL){
+        if(status!=NULL) {
+            *status = SEASON_MEMORY_ERROR;
+        }
         return NULL;
     }
     if(status!=NULL){
-        *status=season_allocation_status;
+        *status=SEASON_OK;
     }
     return new_season;
 }
 
 /**
- ***** Function: SeasonDestroy *****
- * Description: freeing all allocated memory of season including all the
- * elements in array: drivers, teams and their pointers.
- * @param season - A pointer to a season.
+ ***** Function: SeasonParserCreate *****
+ * Description: creates a parser which builds a season from season info that
+ * arrives in chunks (e.g. from a pipe). Only the line which is cut by the
+ * end of a chunk is buffered, the rest of the chunk is parsed in place.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @return - A pointer to the parser.
  */
-void SeasonDestroy(Season season) {
-    if(season==NULL){
-        return;
+SeasonParser SeasonParserCreate(SeasonStatus* status){
+    SeasonParser parser = malloc(sizeof(*parser));
+    Season season = SeasonAllocation();
+    if (parser==NULL || season==NULL){
+        free(parser);
+        SeasonDestroy(season);
+        if(status!=NULL){
+            *status=SEASON_MEMORY_ERROR;
+        }
+        return NULL;
     }
-    /* Destroys all teams and their drivers. */
-    for (int j = 0; j < season->number_of_teams; j++){
-        TeamDestroy((season->team_array)[j]);
+    RosterParser roster = {season, -1, 0, 0};
+    parser->roster = roster;
+    parser->failed = false;
+    parser->pending = NULL;
+    parser->pending_length = 0;
+    parser->pending_capacity = 0;
+    if(status!=NULL){
+        *status=SEASON_OK;
     }
-    free(season->drivers_array);
-    free(season->team_array);
-    free(season->last_race_results_array);
-    free(season);
+    return parser;
 }
 
 /**
- ***** Function: SeasonGetNumberOfDrivers *****
- * Description: gets the number of drivers in a given season.
- * @param season - A pointer to a season.
- * @return - Number of drivers in the season.
+ ***** Function: SeasonParserFeed *****
+ * Description: parses the next chunk of the season info. The teams and
+ * drivers of every complete line are created right away.
+ * @param parser - A pointer to a parser.
+ * @param buffer - The next chunk, lines may be cut anywhere.
+ * @param length - Length of the chunk.
+ * @return - Success/fail +reason of the function. After a failure the
+ * parser ignores the rest of the input and SeasonParserFinish fails.
  */
-int SeasonGetNumberOfDrivers(Season season){
-    if (season==NULL){
-        return 0;
+SeasonStatus SeasonParserFeed(SeasonParser parser, const char* buffer,
+                              size_t length){
+    if (parser==NULL || (buffer==NULL && length>0)){
+        return SEASON_NULL_PTR;
     }
-    return season->number_of_drivers;
+    if (parser->failed){
+        return SEASON_MEMORY_ERROR;
+    }
+    if (length==0){
+        return SEASON_OK;
+    }
+    const char* data = buffer;
+    if (parser->pending_length>0){
+        /* Completes the pending line with the start of the chunk. */
+        const char* line_end = memchr(buffer, '\n', length);
+        size_t piece = (line_end!=NULL) ? (size_t)(line_end-buffer) : length;
+        if (!SeasonParserKeepPending(parser, buffer, piece)){
+            parser->failed = true;
+            return SEASON_MEMORY_ERROR;
+        }
+        if (line_end==NULL){
+            return SEASON_OK;
+        }
+        if (!RosterParserAddLine(&parser->roster, parser->pending,
+                                 parser->pending_length)){
+            parser->failed = true;
+            return SEASON_MEMORY_ERROR;
+        }
+        parser->pending_length = 0;
+        data = line_end+1;
+    }
+    size_t left = length-(size_t)(data-buffer);
+    const char* last_line = RosterParserAddLines(&parser->roster, data, left);
+    if (last_line==NULL ||
+        !SeasonParserKeepPending(parser, last_line,
+                                 (size_t)(data+left-last_line))){
+        parser->failed = true;
+        return SEASON_MEMORY_ERROR;
+    }
+    return SEASON_OK;
 }
 
 /**
- ***** Function: SeasonGetNumberOfTeams *****
- * Description: gets the number of teams in the current season.
- * @param season - a pointer to a season.
- * @return number of teams of the season.
+ ***** Function: SeasonParserFinish *****
+ * Description: parses the last line of the season info (which does not
+ * have to end with '\n'), destroys the parser and returns the season.
+ * @param parser - A pointer to a parser.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @return - A pointer to the season or NULL in case of failure.
  */
-int SeasonGetNumberOfTeams(Season season){
-    /* 'season' is not a valid pointer therefore doesn't have teams. */
-    if(season==NULL){
-        return 0;
+Season SeasonParserFinish(SeasonParser parser, SeasonStatus* status){
+    if (parser==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return NULL;
     }
-    return season->number_of_teams;
+    Season season = parser->roster.season;
+    bool created = !parser->failed &&
+                   (parser->pending_length==0 ||
+                    RosterParserAddLine(&parser->roster, parser->pending,
+                                        parser->pending_length)) &&
+                   SeasonFinishCreation(season);
+    parser->roster.season = NULL;
+    SeasonParserDestroy(parser);
+    if (!created){
+        SeasonDestroy(season);
+        if(status!=NULL){
+            *status=SEASON_MEMORY_ERROR;
+        }
+        return NULL;
+    }
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    return season;
 }
 
 /**
- ***** Function : SeasonGetTeamStandings *****
- * Description: sorting the teams in the season by their points.
+ ***** Function: SeasonParserDestroy *****
+ * Description: destroys a parser without finishing it, including the
+ * season it was building.
+ * @param parser - A pointer to a parser.
+ */
+void SeasonParserDestroy(SeasonParser parser){
+    if (parser==NULL){
+        return;
+    }
+    SeasonDestroy(parser->roster.season);
+    free(parser->pending);
+    free(parser);
+}
+
+/**
+ ***** Function: SeasonSave *****
+ * Description: writes a binary snapshot of the season: the year, the teams
+ * and drivers, the points of the drivers and the last race results.
  * @param season - A pointer to a season.
- * @return - A pointer to a sorted team array.
+ * @param path - Path of the snapshot file.
+ * @return - Success/fail +reason of the function.
  */
-Team* SeasonGetTeamsStandings(Season season){
-    if(season==NULL){
-        return NULL;
+SeasonStatus SeasonSave(Season season, const char* path){
+    if (season==NULL || path==NULL){
+        return SEASON_NULL_PTR;
     }
-    TeamStatus status;
-    int index_of_max_points_team=0;
-    Team* sorted_team_array=
-            malloc(sizeof(*sorted_team_array)*season->number_of_teams);
-    if(sorted_team_array==NULL){
-        return NULL;
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.year = season->year;
+    header.number_of_teams = season->number_of_teams;
+    header.number_of_drivers = season->number_of_drivers;
+    for (int j=0;j<season->number_of_teams;j++){
+        header.names_size += strlen(TeamGetName(season->team_array[j]))+1;
     }
-    int* team_points_array=
-            malloc(sizeof(team_points_array)*season->number_of_teams);
-    if(team_points_array==NULL){
-        free(sorted_team_array);
-        return NULL;
+    for (int i=0;i<season->number_of_drivers;i++){
+        header.names_size += strlen(DriverGetName(season->drivers_array[i]))+1;
     }
-    /* 'team_points_array' will contain in index i the number of points
-     * of team i in the teams array found in the season. */
-    for (int i=0;i<(season->number_of_teams);i++) {
-        team_points_array[i]=TeamGetPoints(season->team_array[i],&status);
-        if (status==TEAM_NULL_PTR){ // Error reading team points.
-            free(sorted_team_array);
-            free(team_points_array);
-            return NULL;
-        }
+    SnapshotLayout layout;
+    SnapshotLayoutCompute(&layout, season->number_of_teams,
+                          season->number_of_drivers, header.names_size);
+    FILE* file = fopen(path, "wb");
+    if (file==NULL){
+        return SEASON_FILE_ERROR;
     }
-    for (int j=0;j<season->number_of_teams;j++){
-        index_of_max_points_team= FindIndexOfMaxPointsTeam(
-                season, team_points_array, season->number_of_teams);
-        sorted_team_array[j]=
-                season->team_array[index_of_max_points_team];
+    bool written = fwrite(&header, sizeof(header), 1, file)==1 &&
+                   SnapshotWriteNames(file, season);
+    for (int i=0;written && i<season->number_of_drivers;i++){
+        int32_t points = season->drivers_points[i];
+        written = fwrite(&points, sizeof(points), 1, file)==1;
     }
-    free(team_points_array);
-    return sorted_team_array;
+    written = written && SnapshotPad(file, layout.drivers_teams);
+    for (int i=0;written && i<season->number_of_drivers;i++){
+        int32_t team = season->drivers_teams[i];
+        written = fwrite(&team, sizeof(team), 1, file)==1;
+    }
+    written = written && SnapshotPad(file, layout.last_race_results);
+    for (int i=0;written && i<season->number_of_drivers;i++){
+        int32_t id = season->last_race_results_array[i];
+        written = fwrite(&id, sizeof(id), 1, file)==1;
+    }
+    written = written && SnapshotPad(file, layout.names);
+    for (int j=0;written && j<season->number_of_teams;j++){
+        const char* name = TeamGetName(season->team_array[j]);
+        written = fwrite(name, strlen(name)+1, 1, file)==1;
+    }
+    for (int i=0;written && i<season->number_of_drivers;i++){
+        const char* name = DriverGetName(season->drivers_array[i]);
+        written = fwrite(name, strlen(name)+1, 1, file)==1;
+    }
+    if (fclose(file)!=0 || !written){
+        return SEASON_FILE_ERROR;
+    }
+    return SEASON_OK;
 }
 
 /**
- ***** Function : SeasonGetTeamByPosition *****
- * Description: returns a team pointer by it's rank.
- * @param season - A pointer to a season.
- * @param position - A position in the sorted teams array.
- * @param status - Will hold success or failure.
- * @return - A pointer to a team by its position in the sorted team array.
+ ***** Function: SeasonLoad *****
+ * Description: creates a season from a snapshot written by SeasonSave,
+ * without replaying its races. The snapshot is memory mapped and the
+ * season is restored from it into a single block.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @param path - Path of the snapshot file.
+ * @return - A pointer to the season.
  */
-Team SeasonGetTeamByPosition(Season season, int position,
-                             SeasonStatus* status){
-    if (season==NULL){
+Season SeasonLoad(SeasonStatus* status, const char* path){
+    if (path==NULL){
         if(status!=NULL){
             *status=SEASON_NULL_PTR;
         }
         return NULL;
     }
-    if(position<1 || position>season->number_of_teams){
-        if(status!=NULL){
-            *status=SEASON_NULL_PTR;
-        }
-        return NULL;
+    int file = open(path, O_RDONLY);
+    struct stat file_stat;
+    void* map = MAP_FAILED;
+    if (file>=0 && fstat(file, &file_stat)==0 && file_stat.st_size>0){
+        map = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE,
+                   file, 0);
     }
-    /* Sorted_team_array will hold a new (new pointer) array sorted by
-     * each team's points */
-    Team* sorted_team_array=SeasonGetTeamsStandings(season);
-    if(status!=NULL){
-        *status=SEASON_OK;
+    if (file>=0){
+        close(file);
     }
-    Team team=sorted_team_array[position-1];
-    /* Searches for the wanted team in the team array found in season
-         by comparing teams names. */
-    for (int i=0;i<season->number_of_teams;i++) {
-        if(!strcmp(TeamGetName(team),TeamGetName(season->team_array[i]))){
-            team=season->team_array[i];
-            free(sorted_team_array);
-            return team;
+    if (map==MAP_FAILED){
+        if(status!=NULL){
+            *status=SEASON_FILE_ERROR;
         }
+        return NULL;
     }
-    /* Shouldn't get here. */
-    return NULL;
+    size_t size = (size_t)file_stat.st_size;
+    Season season = SeasonRestoreSnapshot(map, size, status);
+    munmap(map, size);
+    return season;
 }
 
 /**
- ***** Function : SeasonGetDriverByPosition *****
- * Description: returns a drivers pointer by it's rank.
- * @param season - A pointer to season.
- * @param position - A position in the sorted drivers array.
- * @param status - Will hold success or failure.
- * @return - A pointer to a driver by its position in the sorted drivers array.
+ ***** Function: SeasonClone *****
+ * Description: creates an independent copy of a season, for "what if"
+ * scenarios: races added to the clone don't change the season and the
+ * other way around. The first clone of a season copies the names of its
+ * teams and drivers once; the season and all its clones (and theirs) share
+ * that copy, which is freed with the last of them. A destroyed season
+ * frees the rest of its memory right away, even while clones are alive.
+ * The clone lives in a single block and its standings are copied, so
+ * nothing is sorted or parsed. A season may be cloned by several threads
+ * at once as long as no thread changes it meanwhile.
+ * @param season - A pointer to a season.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @return - A pointer to the clone or NULL in case of failure.
  */
-Driver SeasonGetDriverByPosition(Season season, int position,
-                                 SeasonStatus* status){
+Season SeasonClone(Season season, SeasonStatus* status){
     if (season==NULL){
         if(status!=NULL){
             *status=SEASON_NULL_PTR;
         }
         return NULL;
     }
-    if(position<1 || position>season->number_of_drivers){
-        *status=SEASON_NULL_PTR;
+    int n = season->number_of_drivers;
+    int t = season->number_of_teams;
+    Season clone = SeasonBlockAllocation(t, n, 0);
+    if (clone==NULL || !SeasonCloneRoster(clone, season) ||
+        !SeasonRaceStateAllocation(clone)){
+        SeasonDestroy(clone);
+        if(status!=NULL){
+            *status=SEASON_MEMORY_ERROR;
+        }
         return NULL;
     }
-    /* Sorted_driver_array will hold a new (new pointer) array sorted by
-     * each driver's points */
-    Driver* sorted_driver_array=SeasonGetDriversStandings(season);
-    int id = DriverGetId(sorted_driver_array[position-1]);
-    /* Searches for the wanted driver in the driver array found in season
-         by comparing drivers ids. */
-    free(sorted_driver_array);
-    for(int i=0;i<season->number_of_drivers;i++){
-        if(DriverGetId(season->drivers_array[i])==id){
-            if(status!=NULL){
-                *status=SEASON_OK;
-            }
-            return season->drivers_array[i];
-        }
+    clone->year = season->year;
+    clone->standings_backend = season->standings_backend;
+    memcpy(clone->drivers_points, season->drivers_points,
+           sizeof(*clone->drivers_points)*(size_t)n);
+    memcpy(clone->last_race_results_array, season->last_race_results_array,
+           sizeof(*clone->last_race_results_array)*(size_t)n);
+    memcpy(clone->last_race_positions, season->last_race_positions,
+           sizeof(*clone->last_race_positions)*(size_t)n);
+    /* A stale ranking stays stale in the clone, so threads cloning the
+     * season at once don't sort it. */
+    memcpy(clone->drivers_ranks, season->drivers_ranks,
+           sizeof(*clone->drivers_ranks)*(size_t)n);
+    clone->drivers_ranking_stale = season->drivers_ranking_stale;
+    memcpy(clone->teams_points, season->teams_points,
+           sizeof(*clone->teams_points)*(size_t)t);
+    memcpy(clone->teams_best_positions, season->teams_best_positions,
+           sizeof(*clone->teams_best_positions)*(size_t)t);
+    /* The ranking is copied instead of sorted again. The teams standings
+     * are sorted by the first query, as after a race. */
+    for (int i=0;i<n;i++){
+        clone->drivers_standings[clone->drivers_ranks[i]-1] =
+                clone->drivers_array[i];
+    }
+    if(status!=NULL){
+        *status=SEASON_OK;
     }
-    return NULL; //Shouldn't get here.
+    return clone;
 }
 
-/** Static functions */
 /**
- ***** Static function : DriverArrayAllocation *****
- *  Description: allocates memory for the drivers array according to the number of drivers
- * and sets it's elements to NULL.
+ ***** Function: SeasonDestroy *****
+ * Description: freeing all allocated memory of season including all the
+ * elements in array: drivers, teams and their pointers.
  * @param season - A pointer to a season.
- * @param season_info_copy - A pointer to the season's info copy string.
- * @param teams_array - A pointer to the array of the teams in the current season.
- * @return - A pointer to the allocated drivers array or NULL in case of memory allocation error.
  */
-static Driver* DriverArrayAllocation(Season season ,Team* teams_array){
-    assert(season!=NULL && teams_array!=NULL);
-    Driver* drivers_array =
-            malloc(sizeof(*drivers_array)*season->number_of_drivers);
-    /* If allocation fails frees all the allocated elements. */
-    if (drivers_array == NULL){
+void SeasonDestroy(Season season) {
+    if(season==NULL){
+        return;
+    }
+    ConcurrentReadsDestroy(season->reads);
+    SharedNamesRelease(season->shared_names);
+    if (season->block_end!=NULL){ // Everything is in the season's block.
+        NameArenaDestroy(&season->names);
         free(season);
-        free(teams_array);
-        return NULL;
+        return;
     }
-    /* Setting array pointers to NULL which helps if memory allocation
-     * fails. */
-    for (int j=0;j<season->number_of_drivers;j++){
-        drivers_array[j] = NULL;
+    /* Destroys all teams and their drivers. */
+    for (int j = 0; j < season->number_of_teams; j++){
+        TeamDestroy((season->team_array)[j]);
     }
-    return drivers_array;
+    free(season->drivers_array);
+    free(season->team_array);
+    free(season->last_race_results_array);
+    free(season->last_race_positions);
+    free(season->drivers_standings);
+    free(season->drivers_ranks);
+    free(season->teams_standings);
+    free(season->standings_keys);
+    free(season->sort_scratch);
+    free(season->teams_points);
+    free(season->drivers_teams);
+    free(season->teams_drivers);
+    free(season->drivers_points);
+    free(season->teams_best_positions);
+    NameArenaDestroy(&season->names);
+    free(season);
 }
 
 /**
- ***** Static function: TeamArrayAllocation *****
- * Description: allocates memory to the teams array according to the number
- * of teams in the season, and sets it's elements to NULL.
+ ***** Function: SeasonDriverPointsChanged *****
+ * Description: keeps a season in line with a change of the points of one of
+ * its drivers made through the driver (DriverAddRaceResult, DriverSetPoints
+ * or DriverSetSeason), after the change: the points are added to the
+ * driver's team, and the standings are sorted again by their next query.
+ * With concurrent reads, the standings are sorted and published to the
+ * readers right away (if that fails for lack of memory, the readers see
+ * the change from the next race on). Does nothing for a driver that is not
+ * one of the season's drivers, or while the season is created.
  * @param season - A pointer to a season.
- * @param season_info_copy - A pointer to the season's info copy string.
- * @return - A pointer to the allocated teams array or NULL in case of
- * memory allocation error.
+ * @param driver - A driver whose points were changed.
+ * @param change - The points added to the driver (negative if taken).
  */
-static Team* TeamArrayAllocation(Season season) {
-    assert(season!=NULL);
-    Team *teams_array =
-            malloc(sizeof(*teams_array)*(season->number_of_teams));
-    if (teams_array == NULL) {
-        free(season);
+void SeasonDriverPointsChanged(Season season, Driver driver, int change){
+    /* drivers_points is the last array a new season allocates. */
+    if (season==NULL || driver==NULL || season->drivers_points==NULL){
+        return;
+    }
+    int index = DriverGetId(driver)-1;
+    if (index<0 || index>=season->number_of_drivers ||
+        season->drivers_array[index]!=driver){
+        return;
+    }
+    int team_index = season->drivers_teams[index];
+    if (team_index>=0){
+        season->teams_points[team_index] += change;
     }
-    for (int i=0;i<season->number_of_teams;i++) {
-        teams_array[i] = NULL;
+    season->drivers_ranking_stale = true;
+    /* Invalidates the cached teams standings. */
+    season->results_generation++;
+    if (season->reads!=NULL){
+        SeasonStandings standings = StandingsTake(season);
+        if (standings!=NULL){
+            StandingsFill(season, standings);
+            StandingsPublish(season, standings);
+        }
     }
-    return teams_array;
 }
 
 /**
- ***** Static Function : SeasonLastRaceResultsArrayAllocation *****
- * Description: allocates memory according to the number of drivers in the
- * season which will contain the last race results.
+ ***** Function: SeasonSetStandingsBackend *****
+ * Description: selects the algorithm that ranks the drivers after each race.
+ * STANDINGS_BACKEND_AUTO (the default) uses a sorting network for seasons of
+ * at most 32 drivers, the radix sort when the points range is small and the
+ * comparison sort otherwise. STANDINGS_BACKEND_NETWORK ranks bigger seasons
+ * as the automatic backend does. Teams are sorted by a sorting network too
+ * when there are at most 32 of them, unless the comparison or the radix
+ * backend is selected. The ranking itself does not depend on the backend.
  * @param season - A pointer to a season.
- * @param season_info_copy - A pointer to the season's info copy string.
- * @return - A pointer to the allocated results array or NULL in case of
- * memory allocation error.
+ * @param backend - The backend to use from the next race on.
+ * @return - Success/fail +reason of the function.
  */
-static int* SeasonLastRaceResultsArrayAllocation(Season season){
-    assert(season!=NULL);
+SeasonStatus SeasonSetStandingsBackend(Season season,
+                                       StandingsBackend backend){
+    if (season==NULL){
+        return SEASON_NULL_PTR;
+    }
+    season->standings_backend = backend;
+    return SEASON_OK;
+}
+
+/**
+ ***** Function: SeasonEnableConcurrentReads *****
+ * Description: lets reader threads query the standings while a single
+ * writer thread adds race results. After each race the writer publishes an
+ * immutable copy of the standings. Readers pin the latest copy without
+ * locks and without blocking the writer, and a replaced copy is freed (or
+ * reused) once no reader is pinning it. Has no effect if concurrent reads
+ * are already enabled.
+ * Must be called before the readers start. While readers run, only the
+ * writer may use the season itself; readers use the SeasonReader and
+ * SeasonStandings functions and the names and ids of drivers and teams.
+ * @param season - A pointer to a season.
+ * @param max_readers - Maximal number of readers at the same time.
+ * @return - Success/fail +reason of the function.
+ */
+SeasonStatus SeasonEnableConcurrentReads(Season season, int max_readers){
+    if (season==NULL){
+        return SEASON_NULL_PTR;
+    }
+    if (max_readers<1){
+        return SEASON_NO_READER_SLOT;
+    }
+    if (season->reads!=NULL){
+        return SEASON_OK;
+    }
+    ConcurrentReads* reads = malloc(sizeof(*reads));
+    void* slots = NULL;
+    if (reads==NULL || posix_memalign(&slots, READER_SLOT_SIZE,
+                                      sizeof(ReaderSlot)*max_readers)!=0){
+        free(reads);
+        return SEASON_MEMORY_ERROR;
+    }
+    memset(slots, 0, sizeof(ReaderSlot)*max_readers);
+    reads->slots = slots;
+    reads->max_readers = max_readers;
+    reads->epoch = 1;
+    reads->retired = NULL;
+    reads->free = NULL;
+    reads->current = NULL;
+    season->reads = reads;
+    reads->current = StandingsTake(season);
+    if (reads->current==NULL){
+        ConcurrentReadsDestroy(reads);
+        season->reads = NULL;
+        return SEASON_MEMORY_ERROR;
+    }
+    StandingsFill(season, reads->current);
+    return SEASON_OK;
+}
+
+/**
+ ***** Function: SeasonReaderCreate *****
+ * Description: creates a reader of a season with concurrent reads, taking
+ * one of its reader slots. A reader is used by one thread at a time.
+ * @param season - A pointer to a season.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @return - A pointer to the reader or NULL in case of failure.
+ */
+SeasonReader SeasonReaderCreate(Season season, SeasonStatus* status){
+    if (season==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return NULL;
+    }
+    ConcurrentReads* reads = season->reads;
+    SeasonReader reader = (reads==NULL) ? NULL : malloc(sizeof(*reader));
+    if (reader==NULL){
+        if(status!=NULL){
+            *status = (reads==NULL) ? SEASON_NO_READER_SLOT :
+                                      SEASON_MEMORY_ERROR;
+        }
+        return NULL;
+    }
+    for (int r=0;r<reads->max_readers;r++){
+        int unused = 0;
+        if (__atomic_compare_exchange_n(&reads->slots[r].in_use, &unused, 1,
+                                        false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED)){
+            reader->reads = reads;
+            reader->slot = &reads->slots[r];
+            if(status!=NULL){
+                *status=SEASON_OK;
+            }
+            return reader;
+        }
+    }
+    free(reader);
+    if(status!=NULL){
+        *status=SEASON_NO_READER_SLOT;
+    }
+    return NULL;
+}
+
+/**
+ ***** Function: SeasonReaderDestroy *****
+ * Description: frees a reader (which isn't reading) and its slot.
+ * @param reader - A pointer to a reader.
+ */
+void SeasonReaderDestroy(SeasonReader reader){
+    if (reader==NULL){
+        return;
+    }
+    __atomic_store_n(&reader->slot->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&reader->slot->in_use, 0, __ATOMIC_RELEASE);
+    free(reader);
+}
+
+/**
+ ***** Function: SeasonReaderBegin *****
+ * Description: pins the latest standings published by the writer. They
+ * stay valid and unchanged until SeasonReaderEnd, even if races are added
+ * meanwhile. Doesn't take locks and doesn't allocate memory.
+ * @param reader - A pointer to a reader.
+ * @return - The standings or NULL if the reader is NULL.
+ */
+SeasonStandings SeasonReaderBegin(SeasonReader reader){
+    if (reader==NULL){
+        return NULL;
+    }
+    ConcurrentReads* reads = reader->reads;
+    /* Announcing the epoch before loading the standings means the writer
+     * either sees the announcement before freeing the standings, or
+     * replaced them before they were loaded. */
+    uint64_t epoch = __atomic_load_n(&reads->epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&reader->slot->epoch, epoch, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&reads->current, __ATOMIC_SEQ_CST);
+}
+
+/**
+ ***** Function: SeasonReaderEnd *****
+ * Description: unpins the standings returned by SeasonReaderBegin, which
+ * must not be used after that.
+ * @param reader - A pointer to a reader.
+ */
+void SeasonReaderEnd(SeasonReader reader){
+    if (reader!=NULL){
+        __atomic_store_n(&reader->slot->epoch, 0, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ ***** Function: SeasonStandingsGetDriverByPosition *****
+ * Description: returns the driver in a position of pinned standings.
+ * @param standings - Standings pinned by SeasonReaderBegin.
+ * @param position - A position (1 is the leader).
+ * @param points - If not NULL, will hold the points of the driver.
+ * @return - The driver or NULL if the position is out of range.
+ */
+Driver SeasonStandingsGetDriverByPosition(SeasonStandings standings,
+                                          int position, int* points){
+    if (standings==NULL || position<1 ||
+        position>standings->number_of_drivers){
+        return NULL;
+    }
+    if (points!=NULL){
+        *points = standings->drivers_points[position-1];
+    }
+    return standings->drivers[position-1];
+}
+
+/**
+ ***** Function: SeasonStandingsGetDriverPosition *****
+ * Description: returns the position of a driver in pinned standings.
+ * @param standings - Standings pinned by SeasonReaderBegin.
+ * @param driver - A pointer to a driver of the season.
+ * @param points - If not NULL, will hold the points of the driver.
+ * @return - The position of the driver or 0 if it isn't a driver of the
+ * season.
+ */
+int SeasonStandingsGetDriverPosition(SeasonStandings standings,
+                                     Driver driver, int* points){
+    if (standings==NULL || driver==NULL){
+        return 0;
+    }
+    int id = DriverGetId(driver);
+    if (id<1 || id>standings->number_of_drivers){
+        return 0;
+    }
+    int position = standings->drivers_ranks[id-1];
+    if (standings->drivers[position-1]!=driver){
+        return 0;
+    }
+    if (points!=NULL){
+        *points = standings->drivers_points[position-1];
+    }
+    return position;
+}
+
+/**
+ ***** Function: SeasonStandingsGetTeamByPosition *****
+ * Description: returns the team in a position of pinned standings.
+ * @param standings - Standings pinned by SeasonReaderBegin.
+ * @param position - A position (1 is the leader).
+ * @param points - If not NULL, will hold the points of the team.
+ * @return - The team or NULL if the position is out of range.
+ */
+Team SeasonStandingsGetTeamByPosition(SeasonStandings standings,
+                                      int position, int* points){
+    if (standings==NULL || position<1 ||
+        position>standings->number_of_teams){
+        return NULL;
+    }
+    if (points!=NULL){
+        *points = standings->teams_points[position-1];
+    }
+    return standings->teams[position-1];
+}
+
+/**
+ ***** Function: SeasonGetNumberOfDrivers *****
+ * Description: gets the number of drivers in a given season.
+ * @param season - A pointer to a season.
+ * @return - Number of drivers in the season.
+ */
+int SeasonGetNumberOfDrivers(Season season){
+    if (season==NULL){
+        return 0;
+    }
+    return season->number_of_drivers;
+}
+
+/**
+ ***** Function: SeasonGetNumberOfTeams *****
+ * Description: gets the number of teams in the current season.
+ * @param season - a pointer to a season.
+ * @return number of teams of the season.
+ */
+int SeasonGetNumberOfTeams(Season season){
+    /* 'season' is not a valid pointer therefore doesn't have teams. */
+    if(season==NULL){
+        return 0;
+    }
+    return season->number_of_teams;
+}
+
+/**
+ ***** Function: SeasonGetRaceState *****
+ * Description: copies everything the standings depend on, indexed like the
+ * season keeps it, for code that plays races outside of the season (e.g.
+ * simulations). Drivers are indexed by id-1 and teams by their order in the
+ * season info, which breaks the remaining ties. Every buffer may be NULL if
+ * it isn't needed.
+ * @param season - A pointer to a season.
+ * @param drivers - Will hold the drivers (a buffer of a driver per driver).
+ * @param drivers_points - Will hold the points of the drivers.
+ * @param last_race_positions - Will hold the positions of the drivers in
+ * the last race (0 if there was no race yet).
+ * @param drivers_teams - Will hold the index of the team of each driver (-1
+ * if the driver has no team).
+ * @param teams - Will hold the teams (a buffer of a team per team).
+ * @return - Success/fail +reason of the function.
+ */
+SeasonStatus SeasonGetRaceState(Season season, Driver* drivers,
+                                int* drivers_points, int* last_race_positions,
+                                int* drivers_teams, Team* teams){
+    if (season==NULL){
+        return SEASON_NULL_PTR;
+    }
+    size_t n = (size_t)season->number_of_drivers;
+    if (drivers!=NULL){
+        memcpy(drivers, season->drivers_array, sizeof(*drivers)*n);
+    }
+    if (drivers_points!=NULL){
+        memcpy(drivers_points, season->drivers_points,
+               sizeof(*drivers_points)*n);
+    }
+    if (last_race_positions!=NULL){
+        memcpy(last_race_positions, season->last_race_positions,
+               sizeof(*last_race_positions)*n);
+    }
+    if (drivers_teams!=NULL){
+        memcpy(drivers_teams, season->drivers_teams,
+               sizeof(*drivers_teams)*n);
+    }
+    if (teams!=NULL){
+        memcpy(teams, season->team_array,
+               sizeof(*teams)*(size_t)season->number_of_teams);
+    }
+    return SEASON_OK;
+}
+
+/**
+ ***** Function : SeasonGetTeamStandings *****
+ * Description: sorting the teams in the season by their points.
+ * @param season - A pointer to a season.
+ * @return - A new array of the teams sorted by position (the caller has to
+ * free it) or NULL in case of failure.
+ */
+Team* SeasonGetTeamsStandings(Season season){
+    if(season==NULL){
+        return NULL;
+    }
+    Team* sorted_team_array=
+            malloc(sizeof(*sorted_team_array)*season->number_of_teams);
+    if(sorted_team_array==NULL){
+        return NULL;
+    }
+    SeasonGetTeamsStandingsInto(season, sorted_team_array,
+                                season->number_of_teams, NULL);
+    return sorted_team_array;
+}
+
+/**
+ ***** Function : SeasonGetTeamsStandingsInto *****
+ * Description: writes the teams standings into a buffer owned by the
+ * caller. Does not allocate memory.
+ * @param season - A pointer to a season.
+ * @param teams_standings - A buffer which will hold the teams sorted by
+ * position.
+ * @param capacity - Number of teams the buffer can hold.
+ * @param status - Will hold success or failure.
+ * @return - Number of teams written, or the number of teams needed if the
+ * buffer is too small.
+ */
+int SeasonGetTeamsStandingsInto(Season season, Team* teams_standings,
+                                int capacity, SeasonStatus* status){
+    if (season==NULL || teams_standings==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return 0;
+    }
+    if (capacity<season->number_of_teams){
+        if(status!=NULL){
+            *status=SEASON_BUFFER_TOO_SMALL;
+        }
+        return season->number_of_teams;
+    }
+    memcpy(teams_standings, TeamsStandingsCache(season),
+           sizeof(*teams_standings)*season->number_of_teams);
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    return season->number_of_teams;
+}
+
+/**
+ ***** Function : SeasonGetTopDrivers *****
+ * Description: writes the first k drivers of the standings into a buffer
+ * owned by the caller. The ranking is maintained by SeasonAddRaceResult,
+ * so this runs in O(k).
+ * @param season - A pointer to a season.
+ * @param k - Number of drivers wanted.
+ * @param top_drivers - A buffer of at least k drivers.
+ * @return - Number of drivers written (less than k if the season has less
+ * drivers), 0 in case of invalid input.
+ */
+int SeasonGetTopDrivers(Season season, int k, Driver* top_drivers){
+    if (season==NULL || top_drivers==NULL || k<=0){
+        return 0;
+    }
+    if (k>season->number_of_drivers){
+        k = season->number_of_drivers;
+    }
+    DriversRankingCache(season);
+    memcpy(top_drivers, season->drivers_standings, sizeof(*top_drivers)*k);
+    return k;
+}
+
+/**
+ ***** Function : SeasonGetTopTeams *****
+ * Description: writes the first k teams of the standings into a buffer
+ * owned by the caller. If the teams standings are not cached since the last
+ * race, only the first k teams are selected, in O(t log k).
+ * @param season - A pointer to a season.
+ * @param k - Number of teams wanted.
+ * @param top_teams - A buffer of at least k teams.
+ * @return - Number of teams written (less than k if the season has less
+ * teams), 0 in case of invalid input.
+ */
+int SeasonGetTopTeams(Season season, int k, Team* top_teams){
+    if (season==NULL || top_teams==NULL || k<=0){
+        return 0;
+    }
+    if (k>season->number_of_teams){
+        k = season->number_of_teams;
+    }
+    if (season->teams_standings_generation == season->results_generation){
+        memcpy(top_teams, season->teams_standings, sizeof(*top_teams)*k);
+        return k;
+    }
+    StandingsKey* keys = season->standings_keys;
+    TeamsArrayToStandingsKeys(season, keys);
+    SelectTopStandingsKeys(keys, season->number_of_teams, k);
+    for (int j=0;j<k;j++){
+        top_teams[j] = season->team_array[keys[j].index];
+    }
+    return k;
+}
+
+/**
+ ***** Function : SeasonGetTeamByPosition *****
+ * Description: returns a team pointer by it's rank.
+ * @param season - A pointer to a season.
+ * @param position - A position in the sorted teams array.
+ * @param status - Will hold success or failure.
+ * @return - A pointer to a team by its position in the sorted team array.
+ */
+Team SeasonGetTeamByPosition(Season season, int position,
+                             SeasonStatus* status){
+    if (season==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return NULL;
+    }
+    if(position<1 || position>season->number_of_teams){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return NULL;
+    }
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    /* The cached standings hold the season's own team pointers. */
+    return TeamsStandingsCache(season)[position-1];
+}
+
+/**
+ ***** Function : SeasonGetDriverByPosition *****
+ * Description: returns a drivers pointer by it's rank.
+ * @param season - A pointer to season.
+ * @param position - A position in the sorted drivers array.
+ * @param status - Will hold success or failure.
+ * @return - A pointer to a driver by its position in the sorted drivers array.
+ */
+Driver SeasonGetDriverByPosition(Season season, int position,
+                                 SeasonStatus* status){
+    if (season==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return NULL;
+    }
+    if(position<1 || position>season->number_of_drivers){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return NULL;
+    }
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    DriversRankingCache(season);
+    return season->drivers_standings[position-1];
+}
+
+/**
+ ***** Function : SeasonGetDriverPosition *****
+ * Description: returns the current position of a driver in the season.
+ * @param season - A pointer to season.
+ * @param driver - A pointer to a driver of the season.
+ * @param status - Will hold success or failure.
+ * @return - The position of the driver (1 is the leader) or 0 if the driver
+ * is not a driver of the season.
+ */
+int SeasonGetDriverPosition(Season season, Driver driver,
+                            SeasonStatus* status){
+    if (season==NULL || driver==NULL){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return 0;
+    }
+    int id = DriverGetId(driver);
+    if(id<1 || id>season->number_of_drivers ||
+       season->drivers_array[id-1]!=driver){
+        if(status!=NULL){
+            *status=SEASON_NULL_PTR;
+        }
+        return 0;
+    }
+    if(status!=NULL){
+        *status=SEASON_OK;
+    }
+    DriversRankingCache(season);
+    return season->drivers_ranks[id-1];
+}
+
+/** Static functions */
+/**
+ ***** Static Function : SeasonLastRaceResultsArrayAllocation *****
+ * Description: allocates memory according to the number of drivers in the
+ * season which will contain the last race results (or their inverse), and
+ * sets it's elements to 0.
+ * @param season - A pointer to a season.
+ * @return - A pointer to the allocated results array or NULL in case of
+ * memory allocation error.
+ */
+static int* SeasonLastRaceResultsArrayAllocation(Season season){
+    assert(season!=NULL);
     int* last_race_results_array =
-            malloc(sizeof(*last_race_results_array)*season->number_of_drivers);
+            SeasonAllocate(season, sizeof(*last_race_results_array)*
+                                   (season->number_of_drivers+1));
+    if (last_race_results_array == NULL){
+        return NULL;
+    }
+    /* No race took place yet, therefore no driver has a position. */
+    for (int i=0;i<season->number_of_drivers;i++){
+        last_race_results_array[i] = 0;
+    }
     return last_race_results_array;
 }
 
 /**
- ***** Static function:DriversArrayToPointsArray *****
- * Description: adding each driver's points to a given array.
- * @param drivers_points - An array of points of drivers. driver_points[i]
- * contaions points of driver i.
- * @param drivers_array - A pointer to a driver array.
- * @param number_of_drivers - Number of drivers.
+ ***** Static Function : StandingsCacheAllocation *****
+ * Description: allocates the drivers ranking, the cached teams standings,
+ * the teams points and positions and the scratch space used to sort them,
+ * so that no standings query has to allocate memory. The teams cache is marked as
+ * stale.
+ * @param season - A pointer to a season.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the season is left for SeasonDestroy to free).
+ */
+static bool StandingsCacheAllocation(Season season){
+    assert(season!=NULL);
+    season->results_generation = 0;
+    season->teams_standings_generation = -1;
+    season->drivers_standings =
+            SeasonAllocate(season, sizeof(*season->drivers_standings)*
+                                   (season->number_of_drivers+1));
+    season->drivers_ranks =
+            SeasonAllocate(season, sizeof(*season->drivers_ranks)*
+                                   (season->number_of_drivers+1));
+    season->teams_standings =
+            SeasonAllocate(season, sizeof(*season->teams_standings)*
+                                   (season->number_of_teams+1));
+    int keys = (season->number_of_drivers>season->number_of_teams) ?
+            season->number_of_drivers : season->number_of_teams;
+    season->standings_keys =
+            SeasonAllocate(season, sizeof(*season->standings_keys)*
+                                   (keys+1));
+    season->standings_backend = STANDINGS_BACKEND_AUTO;
+    season->sort_scratch =
+            SeasonAllocate(season, sizeof(*season->sort_scratch)*
+                                   (2*season->number_of_drivers+1));
+    season->teams_points =
+            SeasonAllocate(season, sizeof(*season->teams_points)*
+                                   (season->number_of_teams+1));
+    season->teams_best_positions =
+            SeasonAllocate(season, sizeof(*season->teams_best_positions)*
+                                   (season->number_of_teams+1));
+    if (season->teams_points==NULL || season->teams_best_positions==NULL){
+        return false;
+    }
+    /* No race yet, so no team has points or a position. */
+    for (int j=0;j<season->number_of_teams;j++){
+        season->teams_points[j] = 0;
+        season->teams_best_positions[j] = 0;
+    }
+    return season->drivers_standings!=NULL && season->drivers_ranks!=NULL &&
+           season->teams_standings!=NULL && season->standings_keys!=NULL &&
+           season->sort_scratch!=NULL;
+}
+
+/**
+ ***** Static Function : RankDrivers *****
+ * Description: sorts the drivers by their points and last race position
+ * and updates the drivers ranking of the season. Runs once per race, so
+ * position queries are answered in O(1). Small seasons are sorted by a
+ * sorting network, others by the radix backend when the points range is
+ * small (or when it is selected) and by the comparison backend otherwise.
+ * @param season - A pointer to a season.
+ */
+static void RankDrivers(Season season){
+    assert(season!=NULL);
+    /* order[p] will hold the index of the driver in position p+1. */
+    int* order = season->sort_scratch;
+    StandingsBackend backend = season->standings_backend;
+    if (UseSortingNetwork(season, season->number_of_drivers)){
+        NetworkSortDrivers(season, order);
+    }
+    else if (backend == STANDINGS_BACKEND_COMPARISON ||
+             !RadixSortDrivers(season, order,
+                               backend == STANDINGS_BACKEND_RADIX)){
+        ComparisonSortDrivers(season, order);
+    }
+    for(int i=0;i<season->number_of_drivers;i++){
+        season->drivers_standings[i] = season->drivers_array[order[i]];
+        season->drivers_ranks[order[i]] = i+1;
+    }
+    season->drivers_ranking_stale = false;
+}
+
+/**
+ ***** Static Function : DriversRankingCache *****
+ * Description: sorts the drivers again if a change of points made through
+ * a driver left their ranking stale.
+ * @param season - A pointer to a season.
+ */
+static void DriversRankingCache(Season season){
+    assert(season!=NULL);
+    if (season->drivers_ranking_stale){
+        RankDrivers(season);
+    }
+}
+
+/**
+ ***** Static Function : ComparisonSortDrivers *****
+ * Description: sorts the drivers with qsort on their standings keys, in
+ * O(n log n).
+ * @param season - A pointer to a season.
+ * @param order - Will hold the indexes of the drivers sorted by position.
+ */
+static void ComparisonSortDrivers(Season season, int* order){
+    assert(season!=NULL && order!=NULL);
+    /* standings_keys[i] will hold the points and the last race position of
+     * the driver i. */
+    DriversArrayToStandingsKeys(season, season->standings_keys);
+    /* Sorting the drivers by points. The driver with the highest score
+     * will be stored first, and so on.*/
+    qsort(season->standings_keys, (size_t)season->number_of_drivers,
+          sizeof(*season->standings_keys), CompareStandingsKeys);
+    for(int i=0;i<season->number_of_drivers;i++){
+        order[i] = season->standings_keys[i].index;
+    }
+}
+
+/**
+ ***** Static Function : NetworkSortDrivers *****
+ * Description: sorts at most NETWORK_MAX_KEYS drivers with a sorting
+ * network on their standings keys.
+ * @param season - A pointer to a season.
+ * @param order - Will hold the indexes of the drivers sorted by position.
+ */
+static void NetworkSortDrivers(Season season, int* order){
+    assert(season!=NULL && order!=NULL);
+    DriversArrayToStandingsKeys(season, season->standings_keys);
+    NetworkSortStandingsKeys(season->standings_keys,
+                             season->number_of_drivers);
+    for(int i=0;i<season->number_of_drivers;i++){
+        order[i] = season->standings_keys[i].index;
+    }
+}
+
+/**
+ ***** Static Function : RadixSortDrivers *****
+ * Description: sorts the drivers with a stable LSD radix sort on their
+ * points, in O(n) per byte of the points range. The drivers are fed to
+ * the sort in the order of the last race (or by id before the first race),
+ * so drivers with equal points keep the tie-break order of the standings.
+ * @param season - A pointer to a season.
+ * @param order - Will hold the indexes of the drivers sorted by position.
+ * @param force - If false, the sort is done only if the points range is
+ * small enough.
+ * @return - True if the drivers were sorted, false otherwise.
+ */
+static bool RadixSortDrivers(Season season, int* order, bool force){
+    assert(season!=NULL && order!=NULL);
+    int number_of_drivers = season->number_of_drivers;
+    int* buffer = order+number_of_drivers;
+    const int* points = season->drivers_points;
+    int max_points = 0, min_points = 0;
+    for (int i=0;i<number_of_drivers;i++){
+        if (i==0 || points[i]>max_points){
+            max_points = points[i];
+        }
+        if (i==0 || points[i]<min_points){
+            min_points = points[i];
+        }
+    }
+    unsigned int range = (unsigned int)max_points-(unsigned int)min_points;
+    int passes = 0;
+    while (passes*RADIX_BITS<32 && (range>>(passes*RADIX_BITS))!=0){
+        passes++;
+    }
+    if (!force && passes>RADIX_AUTO_MAX_PASSES){
+        return false;
+    }
+    for (int i=0;i<number_of_drivers;i++){
+        order[i] = (season->last_race_results_array[i]>0) ?
+                   season->last_race_results_array[i]-1 : i;
+    }
+    for (int pass=0;pass<passes;pass++){
+        int shift = pass*RADIX_BITS;
+        int counts[RADIX_BUCKETS] = {0};
+        /* The key of a driver grows as its points drop, so sorting the keys
+         * in ascending order sorts the points in descending order. */
+        for (int i=0;i<number_of_drivers;i++){
+            unsigned int key = (unsigned int)max_points-(unsigned int)points[i];
+            counts[(key>>shift)&(RADIX_BUCKETS-1)]++;
+        }
+        for (int bucket=0, start=0;bucket<RADIX_BUCKETS;bucket++){
+            int count = counts[bucket];
+            counts[bucket] = start;
+            start += count;
+        }
+        for (int i=0;i<number_of_drivers;i++){
+            unsigned int key =
+                    (unsigned int)max_points-(unsigned int)points[order[i]];
+            buffer[counts[(key>>shift)&(RADIX_BUCKETS-1)]++] = order[i];
+        }
+        int* temp = order;
+        order = buffer;
+        buffer = temp;
+    }
+    if (passes%2 == 1){
+        /* The sorted indexes ended up in the second buffer. */
+        memcpy(buffer, order, sizeof(*order)*number_of_drivers);
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : TeamsStandingsCache *****
+ * Description: returns the cached teams standings, sorting the teams
+ * again only if a race result was added since the last sort.
+ * @param season - A pointer to a season.
+ * @return - The cached standings array (owned by the season).
+ */
+static Team* TeamsStandingsCache(Season season){
+    assert(season!=NULL);
+    if (season->teams_standings_generation == season->results_generation){
+        return season->teams_standings;
+    }
+    SortTeamsByPoints(season, season->teams_standings);
+    season->teams_standings_generation = season->results_generation;
+    return season->teams_standings;
+}
+
+/**
+ ***** Static Function : SortTeamsByPoints *****
+ * Description: sorting the teams in the season by their points. Teams
+ * with an equal number of points are ordered by the best position of their
+ * drivers in the last race.
+ * @param season - A pointer to a season.
+ * @param sorted_team_array - Will hold the teams sorted by position.
+ */
+static void SortTeamsByPoints(Season season, Team* sorted_team_array){
+    assert(season!=NULL && sorted_team_array!=NULL);
+    StandingsKey* keys = season->standings_keys;
+    TeamsArrayToStandingsKeys(season, keys);
+    if (UseSortingNetwork(season, season->number_of_teams)){
+        NetworkSortStandingsKeys(keys, season->number_of_teams);
+    }
+    else {
+        qsort(keys, (size_t)season->number_of_teams, sizeof(*keys),
+              CompareStandingsKeys);
+    }
+    for (int j=0;j<season->number_of_teams;j++){
+        sorted_team_array[j] = season->team_array[keys[j].index];
+    }
+}
+
+/**
+ ***** Static Function : MapDriversToTeams *****
+ * Description: allocates and fills the driver to team and team to drivers
+ * indexes of the season.
+ * @param season - A pointer to a season.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the season is left for SeasonDestroy to free).
+ */
+static bool MapDriversToTeams(Season season){
+    assert(season!=NULL);
+    season->drivers_teams =
+            SeasonAllocate(season, sizeof(*season->drivers_teams)*
+                                   (season->number_of_drivers+1));
+    season->teams_drivers =
+            SeasonAllocate(season, sizeof(*season->teams_drivers)*2*
+                                   (season->number_of_teams+1));
+    if (season->drivers_teams==NULL || season->teams_drivers==NULL){
+        return false;
+    }
+    for (int i=0;i<season->number_of_drivers;i++){
+        season->drivers_teams[i] = -1;
+    }
+    for (int j=0;j<season->number_of_teams;j++){
+        Driver first = TeamGetDriver(season->team_array[j],FIRST_DRIVER);
+        Driver second = TeamGetDriver(season->team_array[j],SECOND_DRIVER);
+        season->teams_drivers[2*j] = DriverGetId(first)-1;
+        season->teams_drivers[2*j+1] = DriverGetId(second)-1;
+        if (first!=NULL){
+            season->drivers_teams[DriverGetId(first)-1] = j;
+        }
+        if (second!=NULL){
+            season->drivers_teams[DriverGetId(second)-1] = j;
+        }
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : DriversPointsAllocation *****
+ * Description: allocates the points array of the season and moves the
+ * points of every driver into it.
+ * @param season - A pointer to a season.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the season is left for SeasonDestroy to free).
+ */
+static bool DriversPointsAllocation(Season season){
+    assert(season!=NULL);
+    season->drivers_points =
+            SeasonAllocate(season, sizeof(*season->drivers_points)*
+                                   (season->number_of_drivers+1));
+    if (season->drivers_points==NULL){
+        return false;
+    }
+    for (int i=0;i<season->number_of_drivers;i++){
+        DriverSetPointsStorage(season->drivers_array[i],
+                               &season->drivers_points[i]);
+    }
+    return true;
+}
+
+/**
+ ***** Static function: DriversArrayToStandingsKeys *****
+ * Description: fills the standings key of each driver in the season.
+ * @param season - A pointer to a season.
+ * @param keys - An array of standings keys. keys[i] will contain the points
+ * and the last race position of driver i.
+ */
+static void DriversArrayToStandingsKeys(Season season, StandingsKey* keys){
+    assert(season!=NULL && keys!=NULL);
+    for(int i=0;i<season->number_of_drivers;i++){
+        keys[i].points = season->drivers_points[i];
+        keys[i].last_position = season->last_race_positions[i];
+        keys[i].index = i;
+    }
+}
+
+/**
+ ***** Static function: TeamsArrayToStandingsKeys *****
+ * Description: fills the standings key of each team in the season.
+ * @param season - A pointer to a season.
+ * @param keys - An array of standings keys. keys[j] will contain the points
+ * of team j and the best position of its drivers in the last race.
+ */
+static void TeamsArrayToStandingsKeys(Season season, StandingsKey* keys){
+    assert(season!=NULL && keys!=NULL);
+    for (int j=0;j<season->number_of_teams;j++){
+        keys[j].points = season->teams_points[j];
+        keys[j].last_position = season->teams_best_positions[j];
+        keys[j].index = j;
+    }
+}
+
+/**
+ ***** Static function: CompareStandingsKeys *****
+ * Description: qsort comparator of standings keys. A key comes first if it
+ * has more points, if the points are equal the better position in the last
+ * race comes first, and then the lower index.
+ * @param first - A pointer to a standings key.
+ * @param second - A pointer to a standings key.
+ * @return - Negative if 'first' should come first, positive otherwise.
+ */
+static int CompareStandingsKeys(const void* first, const void* second){
+    const StandingsKey* first_key = first;
+    const StandingsKey* second_key = second;
+    if (first_key->points != second_key->points){
+        return (first_key->points > second_key->points) ? -1 : 1;
+    }
+    if (first_key->last_position != second_key->last_position){
+        return (first_key->last_position < second_key->last_position) ? -1 : 1;
+    }
+    return (first_key->index < second_key->index) ? -1 : 1;
+}
+
+/**
+ ***** Static Function : UseSortingNetwork *****
+ * Description: checks if the standings of a season should be sorted by a
+ * sorting network.
+ * @param season - A pointer to a season.
+ * @param count - Number of drivers (or teams) to sort.
+ * @return - True if they are few enough and the backend allows it.
+ */
+static bool UseSortingNetwork(Season season, int count){
+    assert(season!=NULL);
+    return count<=NETWORK_MAX_KEYS &&
+           (season->standings_backend == STANDINGS_BACKEND_AUTO ||
+            season->standings_backend == STANDINGS_BACKEND_NETWORK);
+}
+
+/**
+ ***** Static function: NetworkSortStandingsKeys *****
+ * Description: sorts at most NETWORK_MAX_KEYS standings keys in the order
+ * of CompareStandingsKeys, with Batcher's merge exchange network (Knuth's
+ * algorithm 5.2.2M). Which keys are compared doesn't depend on their
+ * values, and the keys are packed into integers held in a local array, so
+ * every comparator is a branch-free min/max instead of a call through qsort.
+ * @param keys - An array of standings keys.
+ * @param count - Number of keys in the array.
+ */
+static void NetworkSortStandingsKeys(StandingsKey* keys, int count){
+    assert(keys!=NULL && count<=NETWORK_MAX_KEYS);
+    uint64_t packed[NETWORK_MAX_KEYS];
+    for (int i=0;i<count;i++){
+        packed[i] = PackStandingsKey(&keys[i]);
+    }
+    /* top is the biggest power of 2 below count. */
+    int top = 1;
+    while (2*top<count){
+        top *= 2;
+    }
+    for (int p=top;p>0 && count>1;p/=2){
+        int q = top, r = 0, d = p;
+        while (true){
+            /* The comparators start at the indexes i with i&p == r. */
+            for (int block=r;block+d<count;block+=2*p){
+                int end = (block+p+d<count) ? block+p : count-d;
+                for (int i=block;i<end;i++){
+                    uint64_t first = packed[i], second = packed[i+d];
+                    packed[i] = (first<second) ? first : second;
+                    packed[i+d] = (first<second) ? second : first;
+                }
+            }
+            if (q == p){
+                break;
+            }
+            d = q-p;
+            q /= 2;
+            r = p;
+        }
+    }
+    for (int i=0;i<count;i++){
+        UnpackStandingsKey(packed[i], &keys[i]);
+    }
+}
+
+/**
+ ***** Static function: PackStandingsKey *****
+ * Description: packs a standings key into an integer, such that a key
+ * comes first in the standings order iff its packed integer is smaller.
+ * The points take the high half, flipped so more points are smaller, and
+ * the last position and the index (both below 2^16) the low one.
+ * @param key - A pointer to a standings key.
+ * @return - The packed key.
+ */
+static uint64_t PackStandingsKey(const StandingsKey* key){
+    assert(key!=NULL && key->last_position>=0 && key->last_position<=0xFFFF &&
+           key->index>=0 && key->index<=0xFFFF);
+    /* Flipping the sign bit maps the points to unsigned integers in the
+     * same order, and complementing them reverses it. */
+    uint32_t points = ~((uint32_t)key->points^0x80000000u);
+    return ((uint64_t)points<<32) | ((uint64_t)key->last_position<<16) |
+           (uint64_t)key->index;
+}
+
+/**
+ ***** Static function: UnpackStandingsKey *****
+ * Description: restores a standings key packed by PackStandingsKey.
+ * @param packed - A packed standings key.
+ * @param key - Will hold the standings key.
+ */
+static void UnpackStandingsKey(uint64_t packed, StandingsKey* key){
+    assert(key!=NULL);
+    key->points = (int)(~(uint32_t)(packed>>32)^0x80000000u);
+    key->last_position = (int)((packed>>16)&0xFFFF);
+    key->index = (int)(packed&0xFFFF);
+}
+
+/**
+ ***** Static function: SelectTopStandingsKeys *****
+ * Description: moves the first k keys of the standings order to the start
+ * of the array, sorted. Uses a bounded heap whose root is the worst of the
+ * best k keys seen so far, so it runs in O(count log k).
+ * @param keys - An array of standings keys.
+ * @param count - Number of keys in the array.
+ * @param k - Number of keys to select (1 <= k <= count).
+ */
+static void SelectTopStandingsKeys(StandingsKey* keys, int count, int k){
+    assert(keys!=NULL && k>=1 && k<=count);
+    for (int i=k/2-1;i>=0;i--){
+        SiftDownStandingsKey(keys, k, i);
+    }
+    for (int i=k;i<count;i++){
+        if (CompareStandingsKeys(&keys[i], &keys[0]) < 0){
+            keys[0] = keys[i];
+            SiftDownStandingsKey(keys, k, 0);
+        }
+    }
+    qsort(keys, (size_t)k, sizeof(*keys), CompareStandingsKeys);
+}
+
+/**
+ ***** Static function: SiftDownStandingsKey *****
+ * Description: restores the heap order below 'index' in a heap where
+ * every key comes after its children in the standings order.
+ * @param heap - An array of standings keys.
+ * @param size - Number of keys in the heap.
+ * @param index - Index of the key to sift down.
+ */
+static void SiftDownStandingsKey(StandingsKey* heap, int size, int index){
+    assert(heap!=NULL);
+    while (2*index+1<size){
+        int child = 2*index+1;
+        if (child+1<size &&
+            CompareStandingsKeys(&heap[child+1], &heap[child]) > 0){
+            child++;
+        }
+        if (CompareStandingsKeys(&heap[child], &heap[index]) <= 0){
+            return;
+        }
+        StandingsKey temp = heap[index];
+        heap[index] = heap[child];
+        heap[child] = temp;
+        index = child;
+    }
+}
+
+/**
+ ***** Static function: FindBestTeamDriverPosition *****
+ * Description: checks which of each team's drivers has the best position.
+ * @param season - A pointer to a season.
+ * @param team_index - Index of the team in the season's teams array.
+ * @return - The position of the best team's driver (0 if the team has an
+ * empty seat).
+ */
+static int FindBestTeamDriverPosition (Season season,int team_index){
+    assert(season!=NULL && team_index>=0);
+    int first_driver_position,second_driver_position;
+    /* Gets the position of each driver found in the team, an empty seat
+     * (index -1) has the id 0 and therefore the position 0. */
+    first_driver_position=FindLastPositionById(season,
+            season->teams_drivers[2*team_index]+1);
+    second_driver_position=FindLastPositionById(season,
+            season->teams_drivers[2*team_index+1]+1);
+    /* Returns the driver that finished the last race first */
+    if(first_driver_position<second_driver_position){
+        return first_driver_position;
+    }
+    return second_driver_position;
+}
+
+/**
+ * Static function: FindLastPositionById *****
+ * Description: finds the driver's position in the last race by his id in
+ * O(1), using the inverse last race results.
+ * @param season - A pointer to a season.
+ * @param id - A driver's id.
+ * @return - The position of the driver in the last race.
+ */
+static int FindLastPositionById(Season season, int id){
+    assert(season!=NULL);
+    if(id<1 || id>season->number_of_drivers){
+        return 0;
+    }
+    return season->last_race_positions[id-1];
+}
+
+/**
+ ***** Static Function : SeasonAllocation *****
+ * Description: allocates an empty season, without teams and drivers.
+ * @return - A pointer to the season or NULL in case of memory allocation
+ * error.
+ */
+static Season SeasonAllocation(void){
+    Season season = malloc(sizeof(*season));
+    if (season!=NULL){
+        SeasonInitialize(season);
+    }
+    return season;
+}
+
+/**
+ ***** Static Function : SeasonInitialize *****
+ * Description: makes a season empty, without teams, drivers and a block.
+ * @param season - A pointer to an uninitialized season.
+ */
+static void SeasonInitialize(Season season){
+    assert(season!=NULL);
+    NameArena names = {NULL, NULL, 0, NAME_ARENA_BLOCK_SIZE};
+    season->names = names;
+    season->year = 0;
+    season->number_of_teams = 0;
+    season->team_array = NULL;
+    season->number_of_drivers = 0;
+    season->drivers_array = NULL;
+    season->last_race_results_array = NULL;
+    season->last_race_positions = NULL;
+    season->drivers_standings = NULL;
+    season->drivers_ranks = NULL;
+    season->teams_standings = NULL;
+    season->standings_keys = NULL;
+    season->sort_scratch = NULL;
+    season->teams_points = NULL;
+    season->drivers_teams = NULL;
+    season->teams_drivers = NULL;
+    season->drivers_points = NULL;
+    season->teams_best_positions = NULL;
+    season->block_end = NULL;
+    season->block_left = 0;
+    season->reads = NULL;
+    season->shared_names = NULL;
+    season->drivers_ranking_stale = false;
+}
+
+/**
+ ***** Static Function : SeasonBlockAllocation *****
+ * Description: allocates an empty season in a single block, with room for
+ * the given teams, drivers and names and for all the arrays of the season.
+ * The teams and drivers arrays are taken from the block right away.
+ * @param teams - Number of teams.
+ * @param drivers - Number of drivers.
+ * @param names_size - Total size of the names.
+ * @return - A pointer to the season or NULL in case of memory allocation
+ * error.
+ */
+static Season SeasonBlockAllocation(int teams, int drivers,
+                                    size_t names_size){
+    assert(teams>=0 && drivers>=0);
+    size_t size = SeasonBlockSize(teams, drivers, names_size);
+    Season season = malloc(size);
+    if (season==NULL){
+        return NULL;
+    }
+    SeasonInitialize(season);
+    size_t season_size = SeasonBlockRound(sizeof(*season));
+    season->block_end = (char*)season+season_size;
+    season->block_left = size-season_size;
+    season->team_array =
+            SeasonAllocate(season, sizeof(*season->team_array)*(teams+1));
+    season->drivers_array =
+            SeasonAllocate(season, sizeof(*season->drivers_array)*
+                                   (drivers+1));
+    season->names.end = SeasonAllocate(season, names_size);
+    season->names.left = names_size;
+    return season;
+}
+
+/**
+ ***** Static Function : SeasonBlockSize *****
+ * Description: computes the size of the block of a season. It has to match
+ * what SeasonBlockAllocation, the roster parser and SeasonFinishCreation
+ * take from the block.
+ * @param teams - Number of teams.
+ * @param drivers - Number of drivers.
+ * @param names_size - Total size of the names.
+ * @return - The size of the block.
+ */
+static size_t SeasonBlockSize(int teams, int drivers, size_t names_size){
+    /* Every array has room for one more element than needed. */
+    size_t t = (size_t)teams+1;
+    size_t n = (size_t)drivers+1;
+    size_t keys = (n>t) ? n : t;
+    /* The points, the last race results and positions, the ranks, the sort
+     * scratch space (2 per driver) and the team of each driver. */
+    size_t driver_int_arrays = 1+2+1+2+1;
+    /* The points, best positions and drivers (2 per team) of the teams. */
+    size_t team_int_arrays = 2+2;
+    return SeasonBlockRound(sizeof(struct season)) +
+           2*SeasonBlockRound(sizeof(Team)*t) + // The array and standings.
+           2*SeasonBlockRound(sizeof(Driver)*n) + // The array and standings.
+           SeasonBlockRound(names_size) +
+           (size_t)teams*SeasonBlockRound(TeamGetSize()) +
+           (size_t)drivers*SeasonBlockRound(DriverGetSize()) +
+           driver_int_arrays*SeasonBlockRound(sizeof(int)*n) +
+           team_int_arrays*SeasonBlockRound(sizeof(int)*t) +
+           SeasonBlockRound(sizeof(StandingsKey)*keys);
+}
+
+/**
+ ***** Static Function : SeasonBlockRound *****
+ * @param size - A size.
+ * @return - The size rounded up to SEASON_BLOCK_ALIGNMENT.
+ */
+static size_t SeasonBlockRound(size_t size){
+    return (size+SEASON_BLOCK_ALIGNMENT-1)/SEASON_BLOCK_ALIGNMENT*
+           SEASON_BLOCK_ALIGNMENT;
+}
+
+/**
+ ***** Static Function : SeasonAllocate *****
+ * Description: allocates memory which lives as long as the season, from the
+ * block of the season if it has one.
+ * @param season - A pointer to a season.
+ * @param size - Size of the memory.
+ * @return - The memory or NULL in case of memory allocation error.
  */
-static void DriversArrayToPointsArray(int *drivers_points,
-                                      Driver *drivers_array, int number_of_drivers){
-    assert(drivers_array!=NULL && drivers_points!=NULL);
-    DriverStatus status;
-    int points_of_driver_i;
-    for(int i=0;i<number_of_drivers;i++){
-        points_of_driver_i = DriverGetPoints(drivers_array[i],&status);
-        if (status == DRIVER_STATUS_OK){
-            drivers_points[i] = points_of_driver_i;
-        }
+static void* SeasonAllocate(Season season, size_t size){
+    assert(season!=NULL);
+    if (season->block_end==NULL){
+        return malloc(size);
+    }
+    size = SeasonBlockRound(size);
+    assert(size<=season->block_left); // SeasonBlockSize is too small.
+    if (size>season->block_left){
+        return NULL;
     }
+    void* memory = season->block_end;
+    season->block_end += size;
+    season->block_left -= size;
+    return memory;
 }
 
 /**
- ***** Static function: FindBestTeamDriverPosition *****
- * Description: checks which of each team's drivers has the best position.
+ ***** Static Function : SeasonCreateTeam *****
+ * Description: creates a team of the season, in the block of the season if
+ * it has one.
  * @param season - A pointer to a season.
- * @param team - A pointer to a team.
- * @return - The position of the best team's driver.
+ * @param name - The name of the team, owned by the season (may be NULL).
+ * @return - The team or NULL in case of memory allocation error.
  */
-static int FindBestTeamDriverPosition (Season season,Team team){
-    assert(season!=NULL && team!=NULL);
-    int first_driver_position,second_driver_position;
-    /* Gets the position of each driver found in the team*/
-    first_driver_position=
-            (FindLastPositionById(season,DriverGetId
-                    (TeamGetDriver(team,FIRST_DRIVER))));
-    second_driver_position=
-            (FindLastPositionById(season,DriverGetId(
-                    TeamGetDriver(team,SECOND_DRIVER))));
-    /* Returns the driver that finished the last race first */
-    if(first_driver_position<second_driver_position){
-        return first_driver_position;
+static Team SeasonCreateTeam(Season season, char* name){
+    assert(season!=NULL);
+    if (season->block_end==NULL){
+        return TeamCreateNoCopy(NULL,name);
     }
-    return second_driver_position;
+    return TeamCreateAt(SeasonAllocate(season,TeamGetSize()),NULL,name);
 }
 
 /**
- ***** Static function:FindIndexOfMaxPointsDriver *****
- * Description: finds the driver with the highest number of points. In case
- * there are 2 drivers with equal number of points checks which driver got
- * a better position in the last race and returns its index.
- * @param season - A pointer to a season.
- * @param points - A pointer to an array of dirvers points array.
- * @param number_of_drivers - Number of drivers.
- * @return - Index of the driver with max points.
- */
-static int FindIndexOfMaxPointsDriver
-        (Season season, int* points, int number_of_drivers){
-    assert(season!=NULL && points!=NULL);
-    int max = points[0];
-    int index_of_max = 0;
-    for(int i=1;i<number_of_drivers;i++){
-        if(points[i]>max){
-            max = points[i];
-            index_of_max = i;
-        }
-        else if(points[i] == max){
-            /* If two drivers has an equal number of points, compares their
-               position in the last race */
-            if(FindLastPositionById(season,i+1)<
-               FindLastPositionById(season,index_of_max+1)){
-                index_of_max = i;
-            }
+ ***** Static Function : SeasonCreateDriver *****
+ * Description: creates a driver of the season, in the block of the season
+ * if it has one.
+ * @param season - A pointer to a season.
+ * @param name - The name of the driver, owned by the season (may be NULL).
+ * @param id - The id of the driver.
+ * @return - The driver or NULL in case of memory allocation error.
+ */
+static Driver SeasonCreateDriver(Season season, char* name, int id){
+    assert(season!=NULL);
+    if (season->block_end==NULL){
+        return DriverCreateNoCopy(NULL,name,id);
+    }
+    return DriverCreateAt(SeasonAllocate(season,DriverGetSize()),NULL,name,
+                          id);
+}
+
+/**
+ ***** Static Function : SeasonCreateFromRoster *****
+ * Description: creates a season from a whole season info, in a single
+ * block. The block is sized from the number of lines, which bounds the
+ * teams and drivers without parsing them, so the roster itself is still
+ * parsed once.
+ * @param season_info - The season info (does not have to end with '\0').
+ * @param length - Length of the season info.
+ * @return - A pointer to the season or NULL in case of memory allocation
+ * error.
+ */
+static Season SeasonCreateFromRoster(const char* season_info, size_t length){
+    assert(season_info!=NULL);
+    /* After the year line, every third non empty line is a team and the
+     * two lines after it are its drivers. */
+    size_t lines = SeasonCountLines(season_info, length);
+    size_t teams = lines/3+1;
+    if (teams>INT_MAX/2){
+        return NULL;
+    }
+    /* The names are never longer than the season info. */
+    Season season = SeasonBlockAllocation((int)teams, 2*(int)teams,
+                                          length+1);
+    if (season==NULL){
+        return NULL;
+    }
+    /* The arrays are already as big as the bound. */
+    RosterParser parser = {season, -1, (int)teams+1, 2*(int)teams+1};
+    if (!SeasonParseRoster(&parser, season_info, length) ||
+        !SeasonFinishCreation(season)){
+        SeasonDestroy(season);
+        return NULL;
+    }
+    return season;
+}
+
+/**
+ ***** Static Function : SeasonCountLines *****
+ * Description: counts the lines of a season info with the newline scanner.
+ * @param season_info - The season info (does not have to end with '\0').
+ * @param length - Length of the season info.
+ * @return - The number of lines, the last one counted even if it does not
+ * end with '\n'.
+ */
+static size_t SeasonCountLines(const char* season_info, size_t length){
+    assert(season_info!=NULL);
+    size_t newlines[ROSTER_SCAN_BATCH];
+    size_t lines = 1;
+    size_t scanned = 0;
+    size_t found;
+    do {
+        found = ScannerFindNewlines(SCANNER_BACKEND_AUTO,
+                                    season_info+scanned, length-scanned,
+                                    newlines, ROSTER_SCAN_BATCH);
+        lines += found;
+        if (found>0){
+            scanned += newlines[found-1]+1;
         }
+    } while (found==ROSTER_SCAN_BATCH);
+    return lines;
+}
+
+/**
+ ***** Static Function : SeasonParseRoster *****
+ * Description: scans the season info once, line by line, and creates the
+ * teams and drivers of the season. The names are copied into the season's
+ * names arena, and the teams and drivers point into it.
+ * @param parser - A parser before the year line.
+ * @param season_info - The season info (does not have to end with '\0').
+ * @param length - Length of the season info.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the season is left for SeasonDestroy to free).
+ */
+static bool SeasonParseRoster(RosterParser* parser, const char* season_info,
+                              size_t length){
+    assert(parser!=NULL && season_info!=NULL);
+    const char* last_line = RosterParserAddLines(parser, season_info, length);
+    if (last_line==NULL){
+        return false;
     }
-    points[index_of_max] = -1;
-    return index_of_max;
+    /* The last line does not have to end with '\n'. */
+    return RosterParserAddLine(parser, last_line,
+                               (size_t)(season_info+length-last_line));
 }
 
 /**
- * Static function: FindLastPositionById *****
- * Description: finds the driver's position in the last race by his id.
+ ***** Static Function : SeasonFinishCreation *****
+ * Description: allocates the race results and standings of a season whose
+ * teams and drivers were created, and ranks the drivers.
  * @param season - A pointer to a season.
- * @param id - A driver's id.
- * @return - The position of the driver in the last race.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the season is left for SeasonDestroy to free).
  */
-static int FindLastPositionById(Season season, int id){
+static bool SeasonFinishCreation(Season season){
     assert(season!=NULL);
-    for(int i=0;i<season->number_of_drivers;i++){
-        if(season->last_race_results_array[i] == id)
-            return i+1;
+    if (!SeasonRaceStateAllocation(season)){
+        return false;
     }
-    return 0;
+    RankDrivers(season); // No race yet, the drivers are ranked by id.
+    return true;
 }
 
 /**
- ***** Static function : SeasonDriversAndTeamsCreation *****
- * Description: assings the year to a season and creates drivers and teams
- * and assigns them to teams and drivers array.
- * @param season_info - A pointer to a string which contains season info.
- * @param status - Status of the function which holds success or failure.
+ ***** Static Function : SeasonRaceStateAllocation *****
+ * Description: allocates the race results and standings of a season whose
+ * teams and drivers were created, as they are before the first race.
  * @param season - A pointer to a season.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the season is left for SeasonDestroy to free).
  */
-static void SeasonDriversAndTeamsCreation (const char* season_info,
-                                           SeasonStatus* status,Season season){
-    /* drivers_index and team_index represent the indexes in which a
-     * driver\team should be added. Line number counts the number of lines
-     * starting from the first line which a team's name appears
-     * (right after line of the year) */
-    int drivers_index=0, teams_index=0, id=1, line_number=0;
-    TeamStatus team_creation_status;
-    DriverStatus driver_creation_status;
-    char* season_info_copy = malloc((strlen(season_info))+1);
-    /* If allocation fails frees all the allocated elements. */
-    if(season_info_copy == NULL){
-        if (status!=NULL) {
-            *status = SEASON_MEMORY_ERROR;
+static bool SeasonRaceStateAllocation(Season season){
+    assert(season!=NULL);
+    season->last_race_results_array =
+            SeasonLastRaceResultsArrayAllocation(season);
+    season->last_race_positions =
+            SeasonLastRaceResultsArrayAllocation(season);
+    if(season->last_race_results_array == NULL ||
+       season->last_race_positions == NULL ||
+       !StandingsCacheAllocation(season) ||
+       !MapDriversToTeams(season) ||
+       !DriversPointsAllocation(season)) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : SeasonCloneRoster *****
+ * Description: creates the teams and drivers of a clone, with the names
+ * shared by the season, and makes the clone a user of the names.
+ * @param clone - A pointer to an empty season, with room for the teams and
+ * drivers of the season.
+ * @param season - The season to clone.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the clone is left for SeasonDestroy to free).
+ */
+static bool SeasonCloneRoster(Season clone, Season season){
+    assert(clone!=NULL && season!=NULL);
+    SharedNames* shared = SeasonShareNames(season);
+    if (shared==NULL){
+        return false;
+    }
+    clone->shared_names = shared;
+    /* The names are never changed, only shared. */
+    char** drivers_names = shared->names+season->number_of_teams;
+    for (int i=0;i<season->number_of_drivers;i++){
+        Driver driver = SeasonCreateDriver(clone, drivers_names[i], i+1);
+        if (driver==NULL){
+            return false;
         }
-        SeasonDestroy(season);
-        return;
+        DriverSetSeason(driver,clone);
+        clone->drivers_array[clone->number_of_drivers++] = driver;
     }
-    strcpy(season_info_copy,season_info);
-    char* line = strtok(season_info_copy,"\n");
-    /* Converting first line(string of year) to int. */
-    season->year = atoi(line);
-    line = strtok(NULL,"\n");
-    while(line != NULL){
-        if(line_number++%3 == 0){ //Checks if the current line is a team name.
-            season->team_array[teams_index++] =
-                    TeamCreate(&team_creation_status,line);
-            /* If allocation fails frees all the allocated elements. */
-            if (team_creation_status == TEAM_MEMORY_ERROR){
-                SeasonDestroy(season);
-                free(season_info_copy);
-                return;
-            }
+    for (int j=0;j<season->number_of_teams;j++){
+        Team team = SeasonCreateTeam(clone, shared->names[j]);
+        if (team==NULL){
+            return false;
         }
-        else if(!DriverIsNone(line,"None")){  //Checks if the current line is a valid driver name.
-            SetDriversInSeason(line,season->drivers_array,season->team_array,
-                               &id,&driver_creation_status,&drivers_index,&teams_index,season,
-                               season_info_copy);
-            /* If allocation fails frees all the allocated elements. */
-            if(driver_creation_status == DRIVER_MEMORY_ERROR){
-                return;
+        clone->team_array[clone->number_of_teams++] = team;
+        for (int seat=2*j;seat<2*j+2;seat++){
+            int driver_index = season->teams_drivers[seat];
+            if (driver_index>=0){
+                Driver driver = clone->drivers_array[driver_index];
+                TeamAddDriver(team,driver);
+                DriverSetTeam(driver,team);
             }
         }
-        line = strtok(NULL,"\n"); //Line will now hold the next line.
     }
-    free(season_info_copy);
+    return true;
 }
 
 /**
- ***** Static Function : SetDriversInSeason *****
- * Description: creates drivers, putting them in drivers array, sets their
- * season, adding them to their team and setting them to their team.
- * @param driver_name - Driver's name.
- * @param drivers_array - A pointer to drivers array.
- * @param team_array - A pointer to teams array.
- * @param id - Id of driver.
- * @param status - Driver creation status.
- * @param driver_index - Position in driver array.
- * @param team_index - Position in team array.
- * @param season - A pointer to season.
- * @param season_info_copy - Copy of season info string.
- */
-static void SetDriversInSeason(char* driver_name, Driver* drivers_array,
-                               Team* team_array, int* id,DriverStatus* status, int* driver_index,
-                               int* team_index, Season season, char* season_info_copy){
-    drivers_array[(*driver_index)++] = DriverCreate
-            (status,driver_name,(*id)++);
-    /* If allocation fails frees all the allocated elements. */
-    if(*status == DRIVER_MEMORY_ERROR){
-        SeasonDestroy(season);
-        free(season_info_copy);
-        return;
+ ***** Static Function : SeasonShareNames *****
+ * Description: gets the names a season shares with its clones, copying
+ * them on the first clone, and adds a user to them. Several threads may
+ * clone the season at once: only one copy is kept.
+ * @param season - A pointer to a season.
+ * @return - The shared names or NULL in case of memory allocation error.
+ */
+static SharedNames* SeasonShareNames(Season season){
+    assert(season!=NULL);
+    SharedNames* shared = __atomic_load_n(&season->shared_names,
+                                          __ATOMIC_ACQUIRE);
+    if (shared==NULL){
+        SharedNames* copy = SharedNamesCreate(season);
+        if (copy==NULL){
+            return NULL;
+        }
+        if (__atomic_compare_exchange_n(&season->shared_names, &shared,
+                                        copy, false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)){
+            shared = copy;
+        }
+        else { // Another thread shared the names first.
+            free(copy);
+        }
+    }
+    __atomic_add_fetch(&shared->references, 1, __ATOMIC_RELAXED);
+    return shared;
+}
+
+/**
+ ***** Static Function : SharedNamesCreate *****
+ * Description: copies the names of the teams and drivers of a season into
+ * a single allocation, used by the season only.
+ * @param season - A pointer to a season.
+ * @return - The copy or NULL in case of memory allocation error.
+ */
+static SharedNames* SharedNamesCreate(Season season){
+    assert(season!=NULL);
+    int t = season->number_of_teams;
+    int count = t+season->number_of_drivers;
+    size_t size = sizeof(SharedNames)+sizeof(char*)*(size_t)count;
+    for (int k=0;k<count;k++){
+        const char* name = (k<t) ? TeamGetName(season->team_array[k]) :
+                           DriverGetName(season->drivers_array[k-t]);
+        size += (name!=NULL) ? strlen(name)+1 : 0;
+    }
+    SharedNames* shared = malloc(size);
+    if (shared==NULL){
+        return NULL;
     }
-    DriverSetSeason(drivers_array[(*driver_index)-1],season); // Adding the driver to the season.
-    if(TeamAddDriver(team_array[(*team_index)-1],
-                     drivers_array[(*driver_index)-1]) == TEAM_STATUS_OK){ // Driver successfully added to team.
-        DriverSetTeam(drivers_array[(*driver_index)-1],
-                      team_array[(*team_index)-1]); // Setting driver team.
+    shared->references = 1;
+    char* end = (char*)(shared->names+count);
+    for (int k=0;k<count;k++){
+        const char* name = (k<t) ? TeamGetName(season->team_array[k]) :
+                           DriverGetName(season->drivers_array[k-t]);
+        if (name==NULL){
+            shared->names[k] = NULL;
+            continue;
+        }
+        size_t length = strlen(name)+1;
+        shared->names[k] = memcpy(end, name, length);
+        end += length;
     }
+    return shared;
 }
 
 /**
- ***** Static Function: DriversAndTeamsCounter *****
- * Description: counts the number of drivers and teams in the given string.
- * @param drivers - Will hold the number of drivers.
- * @param teams - Will hold the number of teams.
- * @param details - String input that contains the teams and drivers.
- * @param status - Success/fail.
+ ***** Static Function : SharedNamesRelease *****
+ * Description: removes a user of shared names, freeing them after the
+ * last one.
+ * @param shared - Shared names (may be NULL).
  */
-static void DriversAndTeamsCounter(int* drivers, int* teams,
-                                   const char* details,SeasonStatus* status){
-    assert(drivers!=NULL && teams!=NULL && details!=NULL);
-    int number_of_drivers=0, number_of_teams=0;
-    int line_number=0;
-    char* season_details_copy=malloc((strlen(details))+1);
-    if(season_details_copy==NULL){
-        *status = SEASON_MEMORY_ERROR;
-        return;
+static void SharedNamesRelease(SharedNames* shared){
+    if (shared!=NULL &&
+        __atomic_sub_fetch(&shared->references, 1, __ATOMIC_ACQ_REL)==0){
+        free(shared);
+    }
+}
+
+/**
+ ***** Static Function : RosterParserAddLine *****
+ * Description: handles one line of the season info. The first line is the
+ * year, then every third line is a team name and the two lines after it
+ * are the names of its drivers ("None" if the team has no such driver).
+ * Empty lines are skipped.
+ * @param parser - The state of the parser.
+ * @param line - The line (without the '\n').
+ * @param length - Length of the line.
+ * @return - True in case of success, false in case of memory allocation
+ * error.
+ */
+static bool RosterParserAddLine(RosterParser* parser, const char* line,
+                                size_t length){
+    assert(parser!=NULL && parser->season!=NULL && line!=NULL);
+    Season season = parser->season;
+    if (length==0){
+        return true;
     }
-    strcpy(season_details_copy,details);
-    char* line = strtok(season_details_copy,"\n");
-    /* Skips the first line which contains the year of the season. */
-    line=strtok(NULL,"\n");
-    while(line!=NULL) {
-        if (line_number % 3 == 0) {
-            number_of_teams++;
+    if (parser->line_number<0){ // The first line holds the year.
+        season->year = ParseYear(line, length);
+        parser->line_number = 0;
+        return true;
+    }
+    if (parser->line_number++%3 == 0){ // The current line is a team name.
+        if (!ArrayReserve((void**)&season->team_array,
+                          &parser->teams_capacity,
+                          season->number_of_teams+1,
+                          sizeof(*season->team_array))){
+            return false;
+        }
+        Team team = SeasonCreateTeam(season,
+                                     NameArenaCopy(&season->names,line,length));
+        if (team==NULL){
+            return false;
         }
-        else if (!DriverIsNone(line,"None")) {
-            number_of_drivers++;
+        season->team_array[season->number_of_teams++] = team;
+        return true;
+    }
+    if (LineIsNone(line, length)){ // The team has no such driver.
+        return true;
+    }
+    if (!ArrayReserve((void**)&season->drivers_array,
+                      &parser->drivers_capacity,
+                      season->number_of_drivers+1,
+                      sizeof(*season->drivers_array))){
+        return false;
+    }
+    Driver driver = SeasonCreateDriver(season,
+                                       NameArenaCopy(&season->names,line,length),
+                                       season->number_of_drivers+1);
+    if (driver==NULL){
+        return false;
+    }
+    Team team = season->team_array[season->number_of_teams-1];
+    season->drivers_array[season->number_of_drivers++] = driver;
+    DriverSetSeason(driver,season); // Adding the driver to the season.
+    if(TeamAddDriver(team,driver) == TEAM_STATUS_OK){
+        DriverSetTeam(driver,team);
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : RosterParserAddLines *****
+ * Description: handles all the complete lines of a piece of season info.
+ * The line ends are found by the scanner, a batch at a time.
+ * @param parser - The state of the parser.
+ * @param data - A piece of the season info.
+ * @param length - Length of the piece.
+ * @return - The start of the last line, which is not complete (it may be
+ * empty), or NULL in case of memory allocation error.
+ */
+static const char* RosterParserAddLines(RosterParser* parser,
+                                        const char* data, size_t length){
+    assert(parser!=NULL && data!=NULL);
+    size_t newlines[ROSTER_SCAN_BATCH];
+    const char* line = data;
+    size_t found;
+    do {
+        size_t scanned = (size_t)(line-data);
+        found = ScannerFindNewlines(SCANNER_BACKEND_AUTO, line,
+                                    length-scanned, newlines,
+                                    ROSTER_SCAN_BATCH);
+        const char* batch = line;
+        for (size_t i=0;i<found;i++){
+            const char* line_end = batch+newlines[i];
+            if (!RosterParserAddLine(parser, line, (size_t)(line_end-line))){
+                return NULL;
+            }
+            line = line_end+1;
         }
-        line = strtok(NULL,"\n");
-        line_number++;
+    } while (found==ROSTER_SCAN_BATCH);
+    return line;
+}
+
+/**
+ ***** Static Function : NameArenaReserve *****
+ * Description: adds a new block to a names arena. The blocks grow
+ * geometrically, so an arena has a few blocks even if its names arrive in
+ * many small pieces.
+ * @param arena - A names arena.
+ * @param size - Minimal size of the block.
+ * @return - True in case of success, false in case of memory allocation
+ * error.
+ */
+static bool NameArenaReserve(NameArena* arena, size_t size){
+    assert(arena!=NULL);
+    if (size<arena->next_block_size){
+        size = arena->next_block_size;
+    }
+    NameBlock* block = malloc(sizeof(*block)+size);
+    if (block==NULL){
+        return false;
+    }
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->end = block->names;
+    arena->left = size;
+    arena->next_block_size = 2*size;
+    return true;
+}
+
+/**
+ ***** Static Function : NameArenaAllocate *****
+ * Description: takes space for names from the end of a names arena.
+ * @param arena - A names arena.
+ * @param size - Size of the space.
+ * @return - The space or NULL in case of memory allocation error.
+ */
+static char* NameArenaAllocate(NameArena* arena, size_t size){
+    assert(arena!=NULL);
+    if (arena->left<size && !NameArenaReserve(arena, size)){
+        return NULL;
+    }
+    char* space = arena->end;
+    arena->end += size;
+    arena->left -= size;
+    return space;
+}
+
+/**
+ ***** Static Function : NameArenaCopy *****
+ * Description: copies a name to the end of a names arena.
+ * @param arena - A names arena.
+ * @param name - The name (without '\0').
+ * @param length - Length of the name.
+ * @return - The copied name or NULL in case of memory allocation error.
+ */
+static char* NameArenaCopy(NameArena* arena, const char* name,
+                           size_t length){
+    assert(arena!=NULL && name!=NULL);
+    char* copy = NameArenaAllocate(arena, length+1);
+    if (copy==NULL){
+        return NULL;
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+/**
+ ***** Static Function : NameArenaDestroy *****
+ * Description: frees all the blocks of a names arena at once.
+ * @param arena - A names arena.
+ */
+static void NameArenaDestroy(NameArena* arena){
+    assert(arena!=NULL);
+    while (arena->blocks!=NULL){
+        NameBlock* next = arena->blocks->next;
+        free(arena->blocks);
+        arena->blocks = next;
+    }
+    arena->end = NULL;
+    arena->left = 0;
+}
+
+/**
+ ***** Static Function : ArrayReserve *****
+ * Description: makes sure an array can hold at least 'needed' elements,
+ * doubling its capacity when it is full.
+ * @param array - A pointer to the array (may point to NULL).
+ * @param capacity - A pointer to the capacity of the array.
+ * @param needed - Number of elements the array has to hold.
+ * @param element_size - Size of an element.
+ * @return - True in case of success, false in case of memory allocation
+ * error (the array is left as it was).
+ */
+static bool ArrayReserve(void** array, int* capacity, int needed,
+                         size_t element_size){
+    assert(array!=NULL && capacity!=NULL);
+    if (needed<=*capacity){
+        return true;
+    }
+    int new_capacity = (*capacity>0) ? *capacity : ROSTER_INITIAL_CAPACITY;
+    while (new_capacity<needed){
+        new_capacity *= 2;
+    }
+    void* new_array = realloc(*array, element_size*(size_t)new_capacity);
+    if (new_array==NULL){
+        return false;
+    }
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ ***** Static Function : ParseYear *****
+ * Description: converts the year line to int, the way atoi does.
+ * @param line - The year line (without '\0').
+ * @param length - Length of the line.
+ * @return - The year.
+ */
+static int ParseYear(const char* line, size_t length){
+    assert(line!=NULL);
+    size_t i = 0;
+    int sign = 1, year = 0;
+    while (i<length && (line[i]==' ' || (line[i]>='\t' && line[i]<='\r'))){
+        i++;
     }
-    *drivers = number_of_drivers;
-    *teams = number_of_teams;
-    free(season_details_copy);
-    *status = SEASON_OK;
+    if (i<length && (line[i]=='-' || line[i]=='+')){
+        sign = (line[i++]=='-') ? -1 : 1;
+    }
+    while (i<length && line[i]>='0' && line[i]<='9'){
+        year = year*10+(line[i++]-'0');
+    }
+    return sign*year;
 }
 
 /**
- ***** Static function : DriverIsNone *****
+ ***** Static function : LineIsNone *****
  * Description: checks if a new driver should be created.
- * @param name - A pointer to a driver's name.
- * @param source - A pointer to the string "None".
+ * @param line - A driver line (without '\0').
+ * @param length - Length of the line.
  * @return - True if the driver's name is None else return false.
  */
-static bool DriverIsNone(char* name, char* source ){
-    assert(name!=NULL && source!=NULL);
-    while (*name || *source){
-        if (*name==*source){
-            name++;
-            source++;
+static bool LineIsNone(const char* line, size_t length){
+    assert(line!=NULL);
+    return length==4 && memcmp(line, "None", 4)==0;
+}
+
+/**
+ ***** Static Function : SeasonParserKeepPending *****
+ * Description: appends the start of a line to the pending line of the
+ * parser. The pending buffer grows up to the length of the longest line.
+ * @param parser - A pointer to a parser.
+ * @param data - A piece of a line.
+ * @param length - Length of the piece.
+ * @return - True in case of success, false in case of memory allocation
+ * error.
+ */
+static bool SeasonParserKeepPending(SeasonParser parser, const char* data,
+                                    size_t length){
+    assert(parser!=NULL);
+    if (length==0){
+        return true;
+    }
+    size_t needed = parser->pending_length+length;
+    if (needed>parser->pending_capacity){
+        size_t capacity = (parser->pending_capacity>0) ?
+                          parser->pending_capacity : ROSTER_INITIAL_CAPACITY;
+        while (capacity<needed){
+            capacity *= 2;
         }
-        else {
+        char* pending = realloc(parser->pending, capacity);
+        if (pending==NULL){
             return false;
         }
+        parser->pending = pending;
+        parser->pending_capacity = capacity;
     }
+    memcpy(parser->pending+parser->pending_length, data, length);
+    parser->pending_length = needed;
     return true;
 }
 
 /**
- ***** Static Function : FindCurrentWinningTeam *****
- * Description: finds the index of the team with the highest points.
- * If two teams has equal number of points checks which of the team's
- * driver's position was highest and returns the index of this team.
- * @param season - A pointer to a season.
- * @param points - A pointer to an array which contains the teams points.
- * @param number_of_teams - Number of teams in the season.
- * @return - Winning team's index.
- */
-static int FindIndexOfMaxPointsTeam
-        (Season season, int *points, int number_of_teams){
-    assert(season!=NULL && points!=NULL);
-    int winning_team_index=0;
-    int max_team_points=points[0];
-    for (int i=1;i<number_of_teams;i++) {
-        if (points[i] > max_team_points) {
-            max_team_points = points[i];
-            winning_team_index = i;
-        }
-        else if (points[i] == max_team_points) {
-            /* If two teams has equal number of points checks which
-               of the team's best drivers has a better position in
-               the last race */
-            if (FindBestTeamDriverPosition(season,season->team_array[i]) <
-                FindBestTeamDriverPosition
-                        (season,season->team_array[winning_team_index])) {
-                winning_team_index = i;
-            }
+ ***** Static Function : SeasonSetLastRace *****
+ * Description: stores the results of the last race, their inverse and the
+ * best position of each team in it.
+ * @param season - A pointer to a season.
+ * @param results - The ids of the drivers by their position in the race.
+ */
+static void SeasonSetLastRace(Season season, const int* results){
+    assert(season!=NULL && results!=NULL);
+    for (int i=0;i<season->number_of_drivers;i++){
+        season->last_race_results_array[i] = results[i];
+        season->last_race_positions[results[i]-1] = i+1;
+    }
+    for (int j=0;j<season->number_of_teams;j++){
+        season->teams_best_positions[j] =
+                FindBestTeamDriverPosition(season,j);
+    }
+}
+
+/**
+ ***** Static Function : RaceResultsAreValid *****
+ * Description: checks that the results of a race hold every id of the
+ * season exactly once.
+ * @param season - A pointer to a season.
+ * @param results - The ids of the drivers by their position in the race.
+ * @param seen - An array of a number per driver. seen[id-1] is set to
+ * 'stamp' for every id of the race.
+ * @param stamp - A number which none of seen's elements is equal to.
+ * @return - True if the results are valid, else false.
+ */
+static bool RaceResultsAreValid(Season season, const int* results,
+                                int* seen, int stamp){
+    assert(season!=NULL && results!=NULL && seen!=NULL);
+    for (int i=0;i<season->number_of_drivers;i++){
+        int id = results[i];
+        if (id<1 || id>season->number_of_drivers || seen[id-1]==stamp){
+            return false;
+        }
+        seen[id-1] = stamp;
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : SnapshotLayoutCompute *****
+ * Description: computes where each section of a snapshot starts.
+ * @param layout - Will hold the offsets of the sections.
+ * @param teams - Number of teams.
+ * @param drivers - Number of drivers.
+ * @param names_size - Size of the names section.
+ */
+static void SnapshotLayoutCompute(SnapshotLayout* layout, int teams,
+                                  int drivers, uint64_t names_size){
+    assert(layout!=NULL && teams>=0 && drivers>=0);
+    size_t ints_size = (sizeof(int32_t)*(size_t)drivers+7)/8*8;
+    layout->teams_names = sizeof(SnapshotHeader);
+    layout->drivers_names = layout->teams_names+sizeof(uint64_t)*(size_t)teams;
+    layout->drivers_points =
+            layout->drivers_names+sizeof(uint64_t)*(size_t)drivers;
+    layout->drivers_teams = layout->drivers_points+ints_size;
+    layout->last_race_results = layout->drivers_teams+ints_size;
+    layout->names = layout->last_race_results+ints_size;
+    layout->size = layout->names+(size_t)names_size;
+}
+
+/**
+ ***** Static Function : SnapshotWriteNames *****
+ * Description: writes the offsets of the teams and drivers names in the
+ * names section.
+ * @param file - The snapshot file.
+ * @param season - A pointer to a season.
+ * @return - True in case of success, else false.
+ */
+static bool SnapshotWriteNames(FILE* file, Season season){
+    assert(file!=NULL && season!=NULL);
+    uint64_t offset = 0;
+    for (int j=0;j<season->number_of_teams;j++){
+        if (fwrite(&offset, sizeof(offset), 1, file)!=1){
+            return false;
+        }
+        offset += strlen(TeamGetName(season->team_array[j]))+1;
+    }
+    for (int i=0;i<season->number_of_drivers;i++){
+        if (fwrite(&offset, sizeof(offset), 1, file)!=1){
+            return false;
+        }
+        offset += strlen(DriverGetName(season->drivers_array[i]))+1;
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : SnapshotPad *****
+ * Description: writes zeros up to the start of the next section.
+ * @param file - The snapshot file.
+ * @param offset - Offset of the next section.
+ * @return - True in case of success, else false.
+ */
+static bool SnapshotPad(FILE* file, size_t offset){
+    assert(file!=NULL);
+    long position = ftell(file);
+    if (position<0){
+        return false;
+    }
+    for (size_t i=(size_t)position;i<offset;i++){
+        if (fputc(0, file)==EOF){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ ***** Static Function : SeasonRestoreSnapshot *****
+ * Description: checks the header of a snapshot and restores its season in
+ * a single block.
+ * @param data - The snapshot.
+ * @param size - Size of the snapshot.
+ * @param status - SEASON_OK in case of success, BAD_SEASON_INFO if the
+ * snapshot is not valid or SEASON_MEMORY_ERROR.
+ * @return - A pointer to the season or NULL in case of failure.
+ */
+static Season SeasonRestoreSnapshot(const char* data, size_t size,
+                                    SeasonStatus* status){
+    assert(data!=NULL);
+    SnapshotHeader header;
+    SnapshotLayout layout;
+    SeasonStatus restore_status = BAD_SEASON_INFO;
+    Season season = NULL;
+    if (size>=sizeof(header)){
+        memcpy(&header, data, sizeof(header));
+    }
+    if (size>=sizeof(header) &&
+        memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic))==0 &&
+        header.version==SNAPSHOT_VERSION && header.number_of_teams>=0 &&
+        header.number_of_drivers>=0 && header.names_size<=size){
+        SnapshotLayoutCompute(&layout, header.number_of_teams,
+                              header.number_of_drivers, header.names_size);
+        if (layout.size==size){
+            season = SeasonBlockAllocation(header.number_of_teams,
+                                           header.number_of_drivers,
+                                           (size_t)header.names_size+1);
+            restore_status = (season==NULL) ? SEASON_MEMORY_ERROR :
+                    SeasonRestoreRoster(season, data, &header, &layout);
+        }
+    }
+    if (restore_status!=SEASON_OK){
+        SeasonDestroy(season);
+        season = NULL;
+    }
+    if(status!=NULL){
+        *status=restore_status;
+    }
+    return season;
+}
+
+/**
+ ***** Static Function : SeasonRestoreRoster *****
+ * Description: checks the sections of a snapshot and restores its teams,
+ * drivers, points and last race.
+ * @param season - A pointer to an empty season, with room for the teams,
+ * drivers and names of the snapshot.
+ * @param data - The snapshot.
+ * @param header - The header of the snapshot.
+ * @param layout - The layout of the snapshot, which matches its size.
+ * @return - SEASON_OK in case of success, BAD_SEASON_INFO if the snapshot
+ * is not valid or SEASON_MEMORY_ERROR (the season is left for
+ * SeasonDestroy to free).
+ */
+static SeasonStatus SeasonRestoreRoster(Season season, const char* data,
+                                        const SnapshotHeader* header,
+                                        const SnapshotLayout* layout){
+    assert(season!=NULL && data!=NULL && header!=NULL && layout!=NULL);
+    if (header->names_size>0 &&
+        data[layout->names+header->names_size-1]!='\0'){
+        return BAD_SEASON_INFO;
+    }
+    const uint64_t* teams_names = (const uint64_t*)(data+layout->teams_names);
+    const uint64_t* drivers_names =
+            (const uint64_t*)(data+layout->drivers_names);
+    const int32_t* drivers_points =
+            (const int32_t*)(data+layout->drivers_points);
+    const int32_t* drivers_teams =
+            (const int32_t*)(data+layout->drivers_teams);
+    const int32_t* last_race_results =
+            (const int32_t*)(data+layout->last_race_results);
+    /* All the names are copied at once. */
+    char* names = NameArenaAllocate(&season->names,
+                                    (size_t)header->names_size+1);
+    if (names==NULL){
+        return SEASON_MEMORY_ERROR;
+    }
+    memcpy(names, data+layout->names, header->names_size);
+    season->year = header->year;
+    for (int j=0;j<header->number_of_teams;j++){
+        if (teams_names[j]>=header->names_size){
+            return BAD_SEASON_INFO;
+        }
+        Team team = SeasonCreateTeam(season, names+teams_names[j]);
+        if (team==NULL){
+            return SEASON_MEMORY_ERROR;
+        }
+        season->team_array[season->number_of_teams++] = team;
+    }
+    for (int i=0;i<header->number_of_drivers;i++){
+        int team_index = drivers_teams[i];
+        if (drivers_names[i]>=header->names_size || team_index<0 ||
+            team_index>=header->number_of_teams){
+            return BAD_SEASON_INFO;
+        }
+        Driver driver = SeasonCreateDriver(season, names+drivers_names[i],
+                                           i+1);
+        if (driver==NULL){
+            return SEASON_MEMORY_ERROR;
+        }
+        Team team = season->team_array[team_index];
+        if (TeamAddDriver(team,driver)!=TEAM_STATUS_OK){ // A full team.
+            return BAD_SEASON_INFO;
+        }
+        season->drivers_array[season->number_of_drivers++] = driver;
+        DriverSetSeason(driver,season);
+        DriverSetTeam(driver,team);
+        DriverSetPoints(driver,drivers_points[i]);
+    }
+    if (!SeasonFinishCreation(season)){
+        return SEASON_MEMORY_ERROR;
+    }
+    for (int i=0;i<season->number_of_drivers;i++){
+        season->teams_points[season->drivers_teams[i]] += drivers_points[i];
+    }
+    /* A season without races has no last race results. */
+    if (season->number_of_drivers>0 && last_race_results[0]!=0){
+        int* results = season->sort_scratch;
+        memcpy(results, last_race_results,
+               sizeof(*results)*(size_t)season->number_of_drivers);
+        /* last_race_positions is zero until the last race is set. */
+        if (!RaceResultsAreValid(season, results,
+                                 season->last_race_positions, 1)){
+            return BAD_SEASON_INFO;
+        }
+        SeasonSetLastRace(season, results);
+        RankDrivers(season);
+    }
+    return SEASON_OK;
+}
+
+/**
+ ***** Static Function : StandingsTake *****
+ * Description: takes standings for the next publication, reusing ones no
+ * reader holds anymore if there are any.
+ * @param season - A pointer to a season with concurrent reads.
+ * @return - The standings (not filled yet) or NULL in case of memory
+ * allocation error.
+ */
+static SeasonStandings StandingsTake(Season season){
+    assert(season!=NULL && season->reads!=NULL);
+    ConcurrentReads* reads = season->reads;
+    SeasonStandings standings = reads->free;
+    if (standings!=NULL){
+        reads->free = standings->next;
+        return standings;
+    }
+    size_t n = (size_t)season->number_of_drivers;
+    size_t t = (size_t)season->number_of_teams;
+    /* The arrays follow the standings in the same allocation, pointers
+     * first so each array is aligned. */
+    standings = malloc(sizeof(*standings)+sizeof(Driver)*n+sizeof(Team)*t+
+                       sizeof(int)*(2*n+t));
+    if (standings==NULL){
+        return NULL;
+    }
+    standings->number_of_drivers = season->number_of_drivers;
+    standings->number_of_teams = season->number_of_teams;
+    standings->drivers = (Driver*)(standings+1);
+    standings->teams = (Team*)(standings->drivers+n);
+    standings->drivers_points = (int*)(standings->teams+t);
+    standings->drivers_ranks = standings->drivers_points+n;
+    standings->teams_points = standings->drivers_ranks+n;
+    standings->next = NULL;
+    return standings;
+}
+
+/**
+ ***** Static Function : StandingsFill *****
+ * Description: copies the current standings of a season.
+ * @param season - A pointer to a season.
+ * @param standings - Standings no reader can see yet.
+ */
+static void StandingsFill(Season season, SeasonStandings standings){
+    assert(season!=NULL && standings!=NULL);
+    int n = season->number_of_drivers;
+    DriversRankingCache(season);
+    memcpy(standings->drivers, season->drivers_standings,
+           sizeof(*standings->drivers)*(size_t)n);
+    memcpy(standings->drivers_ranks, season->drivers_ranks,
+           sizeof(*standings->drivers_ranks)*(size_t)n);
+    for (int p=0;p<n;p++){
+        standings->drivers_points[p] =
+                season->drivers_points[DriverGetId(standings->drivers[p])-1];
+    }
+    /* Sorting the teams leaves their sorted keys in standings_keys. */
+    SortTeamsByPoints(season, season->teams_standings);
+    season->teams_standings_generation = season->results_generation;
+    for (int p=0;p<season->number_of_teams;p++){
+        standings->teams[p] = season->teams_standings[p];
+        standings->teams_points[p] = season->standings_keys[p].points;
+    }
+}
+
+/**
+ ***** Static Function : StandingsPublish *****
+ * Description: makes filled standings the current ones, retires the
+ * replaced standings and reclaims the retired standings no reader holds.
+ * @param season - A pointer to a season with concurrent reads.
+ * @param standings - The new standings.
+ */
+static void StandingsPublish(Season season, SeasonStandings standings){
+    assert(season!=NULL && season->reads!=NULL && standings!=NULL);
+    ConcurrentReads* reads = season->reads;
+    SeasonStandings replaced = __atomic_exchange_n(&reads->current, standings,
+                                                   __ATOMIC_SEQ_CST);
+    /* A reader which announces this epoch (or a later one) loads the new
+     * standings, so only readers of older epochs may hold the replaced. */
+    replaced->retire_epoch = __atomic_add_fetch(&reads->epoch, 1,
+                                                __ATOMIC_SEQ_CST);
+    replaced->next = reads->retired;
+    reads->retired = replaced;
+    StandingsReclaim(reads);
+}
+
+/**
+ ***** Static Function : StandingsReclaim *****
+ * Description: moves the retired standings no reader holds to the free
+ * list.
+ * @param reads - The concurrent reads of a season.
+ */
+static void StandingsReclaim(ConcurrentReads* reads){
+    assert(reads!=NULL);
+    uint64_t oldest = UINT64_MAX;
+    for (int r=0;r<reads->max_readers;r++){
+        uint64_t epoch = __atomic_load_n(&reads->slots[r].epoch,
+                                         __ATOMIC_SEQ_CST);
+        if (epoch!=0 && epoch<oldest){
+            oldest = epoch;
+        }
+    }
+    SeasonStandings* link = &reads->retired;
+    while (*link!=NULL){
+        SeasonStandings standings = *link;
+        if (standings->retire_epoch<=oldest){
+            *link = standings->next;
+            standings->next = reads->free;
+            reads->free = standings;
+        }
+        else {
+            link = &standings->next;
         }
     }
-    points[winning_team_index]=-1;
-    return winning_team_index;
+}
+
+/**
+ ***** Static Function : StandingsListDestroy *****
+ * Description: frees a list of standings.
+ * @param standings - The first standings of the list (may be NULL).
+ */
+static void StandingsListDestroy(SeasonStandings standings){
+    while (standings!=NULL){
+        SeasonStandings next = standings->next;
+        free(standings);
+        standings = next;
+    }
+}
+
+/**
+ ***** Static Function : ConcurrentReadsDestroy *****
+ * Description: frees the concurrent reads state of a season and all its
+ * standings. No reader may be reading.
+ * @param reads - The concurrent reads of a season (may be NULL).
+ */
+static void ConcurrentReadsDestroy(ConcurrentReads* reads){
+    if (reads==NULL){
+        return;
+    }
+    free(reads->current);
+    StandingsListDestroy(reads->retired);
+    StandingsListDestroy(reads->free);
+    free(reads->slots);
+    free(reads);
 }
 /** End of static functions */
\ No newline at end of file
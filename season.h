@@ -8,7 +8,12 @@
 #ifndef SEASON_H_
 #define SEASON_H_
 
+#include <stddef.h>
+
 typedef struct season* Season;
+typedef struct seasonParser* SeasonParser;
+typedef struct seasonReader* SeasonReader;
+typedef struct seasonStandings* SeasonStandings;
 
 #include"team.h"
 #include"driver.h"
@@ -18,16 +23,60 @@ typedef enum seasonStatus {
 	SEASON_OK,
 	SEASON_MEMORY_ERROR,
 	BAD_SEASON_INFO,
-	SEASON_NULL_PTR} SeasonStatus;
+	SEASON_NULL_PTR,
+	SEASON_BUFFER_TOO_SMALL,
+	SEASON_FILE_ERROR,
+	BAD_RACE_RESULTS,
+	SEASON_NO_READER_SLOT} SeasonStatus;
+
+typedef enum standingsBackend {
+	STANDINGS_BACKEND_AUTO,
+	STANDINGS_BACKEND_COMPARISON,
+	STANDINGS_BACKEND_RADIX,
+	STANDINGS_BACKEND_NETWORK} StandingsBackend;
 
 Season SeasonCreate(SeasonStatus* status,const char* season_info);
+Season SeasonCreateFromFile(SeasonStatus* status, const char* path);
+SeasonParser SeasonParserCreate(SeasonStatus* status);
+SeasonStatus SeasonParserFeed(SeasonParser parser, const char* buffer,
+                              size_t length);
+Season SeasonParserFinish(SeasonParser parser, SeasonStatus* status);
+void SeasonParserDestroy(SeasonParser parser);
+SeasonStatus SeasonSave(Season season, const char* path);
+Season SeasonLoad(SeasonStatus* status, const char* path);
+Season SeasonClone(Season season, SeasonStatus* status);
 void   SeasonDestroy(Season season);
 Driver SeasonGetDriverByPosition(Season season, int position, SeasonStatus* status);
+int SeasonGetDriverPosition(Season season, Driver driver, SeasonStatus* status);
 Driver* SeasonGetDriversStandings(Season season);
+int SeasonGetDriversStandingsInto(Season season, Driver* drivers_standings,
+                                  int capacity, SeasonStatus* status);
 Team SeasonGetTeamByPosition(Season season, int position, SeasonStatus* status);
 Team* SeasonGetTeamsStandings(Season season);
+int SeasonGetTeamsStandingsInto(Season season, Team* teams_standings,
+                                int capacity, SeasonStatus* status);
+int SeasonGetTopDrivers(Season season, int k, Driver* top_drivers);
+int SeasonGetTopTeams(Season season, int k, Team* top_teams);
 int SeasonGetNumberOfDrivers(Season season);
 int SeasonGetNumberOfTeams(Season season);
+SeasonStatus SeasonGetRaceState(Season season, Driver* drivers,
+                                int* drivers_points, int* last_race_positions,
+                                int* drivers_teams, Team* teams);
 SeasonStatus SeasonAddRaceResult(Season season, int* results);
+SeasonStatus SeasonAddRaceResults(Season season, const int* results_matrix,
+                                  int races);
+SeasonStatus SeasonSetStandingsBackend(Season season,
+                                       StandingsBackend backend);
+SeasonStatus SeasonEnableConcurrentReads(Season season, int max_readers);
+SeasonReader SeasonReaderCreate(Season season, SeasonStatus* status);
+void SeasonReaderDestroy(SeasonReader reader);
+SeasonStandings SeasonReaderBegin(SeasonReader reader);
+void SeasonReaderEnd(SeasonReader reader);
+Driver SeasonStandingsGetDriverByPosition(SeasonStandings standings,
+                                          int position, int* points);
+int SeasonStandingsGetDriverPosition(SeasonStandings standings,
+                                     Driver driver, int* points);
+Team SeasonStandingsGetTeamByPosition(SeasonStandings standings,
+                                      int position, int* points);
 
 #endif /* SEASON_H_ */
\ No newline at end of file
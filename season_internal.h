@@ -0,0 +1,15 @@
+/*
+ * season_internal.h
+ *
+ * Functions of the season used by its drivers only, not part of the
+ * season's interface.
+ */
+
+#ifndef SEASON_INTERNAL_H_
+#define SEASON_INTERNAL_H_
+
+#include "season.h"
+
+void SeasonDriverPointsChanged(Season season, Driver driver, int change);
+
+#endif /* SEASON_INTERNAL_H_ */
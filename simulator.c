@@ -0,0 +1,744 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include "simulator.h"
+#include "points.h"
+
+/* The simulations are played in chunks, each with a random stream of its
+ * own, so the results don't depend on the number of threads. */
+#define SIMULATOR_CHUNK 1024
+/* The seasons of a chunk are played this many at a time, interleaved, so
+ * the points kernel scores a race in all of them at once. */
+#define SIMULATOR_FUTURES 64
+/* Races and standings of at most this many drivers (or teams) are ranked
+ * by comparing every pair, without branches. Larger races are sorted, and
+ * only the leaders of larger standings are selected. */
+#define SIMULATOR_RANK_KERNEL_MAX 32
+/* Every worker's memory starts on a cache line of its own, so the workers
+ * never write to the same line. */
+#define SIMULATOR_CACHE_LINE 64
+
+typedef struct simulatorKey SimulatorKey;
+typedef struct simulatorRandom SimulatorRandom;
+typedef struct simulatorWorker SimulatorWorker;
+
+/** Declarations */
+static bool SimulatorFindDriver(Simulator simulator, Driver driver,
+                                int* index);
+static SimulatorWorker* SimulatorWorkersCreate(Simulator simulator,
+                                               int threads, int races,
+                                               long long simulations,
+                                               uint64_t seed);
+static void* SimulatorWorkerRun(void* worker);
+static void SimulatorPlayFutures(SimulatorWorker* worker,
+                                 SimulatorRandom* random, int futures);
+static void SimulatorSampleRace(SimulatorWorker* worker,
+                                SimulatorRandom* random, int futures,
+                                int future);
+static void SimulatorCountFutures(SimulatorWorker* worker, int futures);
+static void SimulatorCountLeaders(SimulatorWorker* worker, const int* points,
+                                  const int* positions, int count,
+                                  int futures, long long* titles,
+                                  long long* top_three);
+static int CompareSimulatorKeys(const void* first, const void* second);
+static bool StandingsComesFirst(int first_points, int first_position,
+                                int first_index, int second_points,
+                                int second_position, int second_index);
+static void SimulatorRandomSeed(SimulatorRandom* random, uint64_t seed);
+static uint64_t SimulatorRandomNext(SimulatorRandom* random);
+static double SimulatorRandomExponential(SimulatorRandom* random);
+static uint64_t SplitMix64(uint64_t* state);
+/** End of declarations */
+
+/* A driver's place in a simulated race: the drivers finish by increasing
+ * key. */
+struct simulatorKey {
+    double key;
+    int index;
+};
+
+/* A xoshiro256** generator. */
+struct simulatorRandom {
+    uint64_t state[4];
+};
+
+/* The state of a thread of a run. Everything a worker writes is its own,
+ * and its counters are summed only after all the workers are done. */
+struct simulatorWorker {
+    Simulator simulator;
+    int races;
+    long long simulations; // Of the whole run.
+    int worker; // The worker plays the chunks worker, worker+workers...
+    int workers;
+    uint64_t seed;
+    /* The seasons played together, interleaved: element i*futures+f
+     * belongs to driver (or team) i in season f. */
+    int* points;
+    int* positions; // In the last simulated race.
+    int* teams_points;
+    int* teams_positions; // The best position of the drivers of the team.
+    int* ranks;
+    double* race_keys; // The key of each driver in the sampled race.
+    SimulatorKey* keys; // For sorting races too big to rank by pairs.
+    /* The number of simulated seasons each driver won, finished in the top
+     * three, and each team won. */
+    long long* titles;
+    long long* top_three;
+    long long* constructors_titles;
+    pthread_t thread;
+};
+
+struct simulator {
+    int number_of_drivers;
+    int number_of_teams;
+    /* The season as it was when the simulator was created, indexed like
+     * the season: drivers by id-1 and teams by their order. */
+    Driver* drivers;
+    Team* teams;
+    int* points;
+    int* last_race_positions;
+    int* drivers_teams;
+    int* teams_drivers; // 2 per team, -1 for an empty seat.
+    /* The inverse of the strength of each driver: its key in a race is an
+     * exponential random variable times it. */
+    double* inverse_strengths;
+    long long simulations; // Of the last run, 0 before the first run.
+    long long* titles;
+    long long* top_three;
+    long long* constructors_titles;
+};
+
+/**
+ ***** Function: SimulatorCreate *****
+ * Description: creates a simulator of the rest of a season, starting from
+ * its current points and last race. Every driver has a strength of 1 until
+ * it is set. Later changes of the season don't affect the simulator.
+ * @param season - A pointer to a season.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @return - A pointer to the simulator or NULL in case of failure.
+ */
+Simulator SimulatorCreate(Season season, SimulatorStatus* status){
+    if (season==NULL){
+        if (status!=NULL){
+            *status = SIMULATOR_NULL_PTR;
+        }
+        return NULL;
+    }
+    size_t n = (size_t)SeasonGetNumberOfDrivers(season);
+    size_t t = (size_t)SeasonGetNumberOfTeams(season);
+    Simulator simulator = malloc(sizeof(*simulator));
+    if (simulator!=NULL){
+        /* One more element than needed, so nothing is allocated empty. */
+        simulator->drivers = malloc(sizeof(Driver)*(n+1));
+        simulator->teams = malloc(sizeof(Team)*(t+1));
+        simulator->points = malloc(sizeof(int)*(n+1));
+        simulator->last_race_positions = malloc(sizeof(int)*(n+1));
+        simulator->drivers_teams = malloc(sizeof(int)*(n+1));
+        simulator->teams_drivers = malloc(sizeof(int)*2*(t+1));
+        simulator->inverse_strengths = malloc(sizeof(double)*(n+1));
+        simulator->titles = calloc(2*n+t+1, sizeof(long long));
+    }
+    if (simulator==NULL || simulator->drivers==NULL ||
+        simulator->teams==NULL || simulator->points==NULL ||
+        simulator->last_race_positions==NULL ||
+        simulator->drivers_teams==NULL || simulator->teams_drivers==NULL ||
+        simulator->inverse_strengths==NULL || simulator->titles==NULL){
+        SimulatorDestroy(simulator);
+        if (status!=NULL){
+            *status = SIMULATOR_MEMORY_ERROR;
+        }
+        return NULL;
+    }
+    simulator->number_of_drivers = (int)n;
+    simulator->number_of_teams = (int)t;
+    simulator->simulations = 0;
+    simulator->top_three = simulator->titles+n;
+    simulator->constructors_titles = simulator->top_three+n;
+    SeasonGetRaceState(season, simulator->drivers, simulator->points,
+                       simulator->last_race_positions,
+                       simulator->drivers_teams, simulator->teams);
+    /* The first seat of a team is its driver with the lower id. */
+    for (size_t j=0;j<2*t;j++){
+        simulator->teams_drivers[j] = -1;
+    }
+    for (int i=0;i<(int)n;i++){
+        simulator->inverse_strengths[i] = 1;
+        int team = simulator->drivers_teams[i];
+        if (team>=0){
+            int seat = (simulator->teams_drivers[2*team]<0) ? 0 : 1;
+            simulator->teams_drivers[2*team+seat] = i;
+        }
+    }
+    if (status!=NULL){
+        *status = SIMULATOR_OK;
+    }
+    return simulator;
+}
+
+/**
+ ***** Function: SimulatorDestroy *****
+ * Description: frees a simulator.
+ * @param simulator - A pointer to a simulator.
+ */
+void SimulatorDestroy(Simulator simulator){
+    if (simulator==NULL){
+        return;
+    }
+    free(simulator->drivers);
+    free(simulator->teams);
+    free(simulator->points);
+    free(simulator->last_race_positions);
+    free(simulator->drivers_teams);
+    free(simulator->teams_drivers);
+    free(simulator->inverse_strengths);
+    free(simulator->titles);
+    free(simulator);
+}
+
+/**
+ ***** Function: SimulatorSetDriverStrength *****
+ * Description: sets the finishing distribution of a driver. The races are
+ * Plackett-Luce: a driver wins a race with probability proportional to its
+ * strength, and every next position goes the same way among the drivers
+ * left.
+ * @param simulator - A pointer to a simulator.
+ * @param driver - A driver of the simulated season.
+ * @param strength - A positive number.
+ * @return - Success/fail +reason of the function.
+ */
+SimulatorStatus SimulatorSetDriverStrength(Simulator simulator, Driver driver,
+                                           double strength){
+    if (simulator==NULL || driver==NULL){
+        return SIMULATOR_NULL_PTR;
+    }
+    int index;
+    if (!SimulatorFindDriver(simulator, driver, &index) ||
+        !(strength>0) || !isfinite(1/strength)){
+        return SIMULATOR_BAD_ARGUMENT;
+    }
+    simulator->inverse_strengths[index] = 1/strength;
+    return SIMULATOR_OK;
+}
+
+/**
+ ***** Function: SimulatorRun *****
+ * Description: simulates the remaining races of the season many times and
+ * counts how often every driver wins the title or finishes in the top
+ * three, and how often every team wins the constructors title. The races
+ * are scored and the standings are ordered like SeasonAddRaceResult does.
+ * The simulations are split between the threads, each with its own random
+ * streams and scratch space. The results depend only on the seed, not on
+ * the number of threads, and replace the results of the previous run.
+ * @param simulator - A pointer to a simulator.
+ * @param races - Number of remaining races (may be 0).
+ * @param simulations - Number of simulated seasons.
+ * @param threads - Number of threads to simulate with, the calling thread
+ * included. If a thread can't be started its share is simulated by the
+ * calling thread.
+ * @param seed - The seed of the random streams.
+ * @return - Success/fail +reason of the function.
+ */
+SimulatorStatus SimulatorRun(Simulator simulator, int races,
+                             long long simulations, int threads,
+                             uint64_t seed){
+    if (simulator==NULL){
+        return SIMULATOR_NULL_PTR;
+    }
+    if (races<0 || simulations<1 || threads<1){
+        return SIMULATOR_BAD_ARGUMENT;
+    }
+    long long chunks = (simulations+SIMULATOR_CHUNK-1)/SIMULATOR_CHUNK;
+    if (threads>chunks){
+        threads = (int)chunks;
+    }
+    SimulatorWorker* workers = SimulatorWorkersCreate(simulator, threads,
+                                                      races, simulations,
+                                                      seed);
+    if (workers==NULL){
+        return SIMULATOR_MEMORY_ERROR;
+    }
+    /* started[w] is true if worker w runs in a thread of its own. */
+    bool* started = calloc((size_t)threads, sizeof(*started));
+    for (int w=1;w<threads && started!=NULL;w++){
+        started[w] = pthread_create(&workers[w].thread, NULL,
+                                    SimulatorWorkerRun, &workers[w])==0;
+    }
+    SimulatorWorkerRun(&workers[0]);
+    /* Sums the counters of the workers once they are all done. */
+    int n = simulator->number_of_drivers;
+    int t = simulator->number_of_teams;
+    memset(simulator->titles, 0, sizeof(long long)*(size_t)(2*n+t));
+    for (int w=0;w<threads;w++){
+        if (started!=NULL && started[w]){
+            pthread_join(workers[w].thread, NULL);
+        }
+        else if (w>0){
+            SimulatorWorkerRun(&workers[w]);
+        }
+        for (int i=0;i<n;i++){
+            simulator->titles[i] += workers[w].titles[i];
+            simulator->top_three[i] += workers[w].top_three[i];
+        }
+        for (int j=0;j<t;j++){
+            simulator->constructors_titles[j] +=
+                    workers[w].constructors_titles[j];
+        }
+    }
+    simulator->simulations = simulations;
+    for (int w=0;w<threads;w++){
+        free(workers[w].titles);
+    }
+    free(started);
+    free(workers);
+    return SIMULATOR_OK;
+}
+
+/**
+ ***** Function: SimulatorGetTitleProbability *****
+ * @param simulator - A pointer to a simulator.
+ * @param driver - A driver of the simulated season.
+ * @return - The probability of the driver to win the title in the last
+ * run, or 0 if there was no run or the driver isn't in the season.
+ */
+double SimulatorGetTitleProbability(Simulator simulator, Driver driver){
+    int index;
+    if (simulator==NULL || simulator->simulations==0 ||
+        !SimulatorFindDriver(simulator, driver, &index)){
+        return 0;
+    }
+    return (double)simulator->titles[index]/(double)simulator->simulations;
+}
+
+/**
+ ***** Function: SimulatorGetTopThreeProbability *****
+ * @param simulator - A pointer to a simulator.
+ * @param driver - A driver of the simulated season.
+ * @return - The probability of the driver to finish the season in the top
+ * three in the last run, or 0 if there was no run or the driver isn't in
+ * the season.
+ */
+double SimulatorGetTopThreeProbability(Simulator simulator, Driver driver){
+    int index;
+    if (simulator==NULL || simulator->simulations==0 ||
+        !SimulatorFindDriver(simulator, driver, &index)){
+        return 0;
+    }
+    return (double)simulator->top_three[index]/
+           (double)simulator->simulations;
+}
+
+/**
+ ***** Function: SimulatorGetConstructorsTitleProbability *****
+ * @param simulator - A pointer to a simulator.
+ * @param team - A team of the simulated season.
+ * @return - The probability of the team to win the constructors title in
+ * the last run, or 0 if there was no run or the team isn't in the season.
+ */
+double SimulatorGetConstructorsTitleProbability(Simulator simulator,
+                                                Team team){
+    if (simulator==NULL || simulator->simulations==0 || team==NULL){
+        return 0;
+    }
+    for (int j=0;j<simulator->number_of_teams;j++){
+        if (simulator->teams[j]==team){
+            return (double)simulator->constructors_titles[j]/
+                   (double)simulator->simulations;
+        }
+    }
+    return 0;
+}
+
+/** Static functions */
+/**
+ ***** Static Function : SimulatorFindDriver *****
+ * @param simulator - A pointer to a simulator.
+ * @param driver - A pointer to a driver (may be NULL).
+ * @param index - Will hold the index of the driver.
+ * @return - True if the driver is in the simulated season, else false.
+ */
+static bool SimulatorFindDriver(Simulator simulator, Driver driver,
+                                int* index){
+    assert(simulator!=NULL && index!=NULL);
+    if (driver==NULL){
+        return false;
+    }
+    int id = DriverGetId(driver);
+    if (id<1 || id>simulator->number_of_drivers ||
+        simulator->drivers[id-1]!=driver){
+        return false;
+    }
+    *index = id-1;
+    return true;
+}
+
+/**
+ ***** Static Function : SimulatorWorkersCreate *****
+ * Description: creates the workers of a run. The scratch space and the
+ * counters of each worker are a single allocation aligned to a cache line.
+ * @param simulator - A pointer to a simulator.
+ * @param threads - Number of workers.
+ * @param races - Number of races to simulate.
+ * @param simulations - Number of simulated seasons.
+ * @param seed - The seed of the run.
+ * @return - The workers or NULL in case of memory allocation error.
+ */
+static SimulatorWorker* SimulatorWorkersCreate(Simulator simulator,
+                                               int threads, int races,
+                                               long long simulations,
+                                               uint64_t seed){
+    assert(simulator!=NULL && threads>0);
+    size_t n = (size_t)simulator->number_of_drivers+1;
+    size_t t = (size_t)simulator->number_of_teams+1;
+    size_t futures = SIMULATOR_FUTURES;
+    size_t ranks = (n>t) ? n : t;
+    size_t size = sizeof(long long)*(2*n+t)+sizeof(double)*n+
+                  sizeof(SimulatorKey)*n+sizeof(int)*futures*(2*n+2*t+ranks);
+    size = (size+SIMULATOR_CACHE_LINE-1)/SIMULATOR_CACHE_LINE*
+           SIMULATOR_CACHE_LINE;
+    SimulatorWorker* workers = calloc((size_t)threads, sizeof(*workers));
+    if (workers==NULL){
+        return NULL;
+    }
+    for (int w=0;w<threads;w++){
+        void* memory = NULL;
+        if (posix_memalign(&memory, SIMULATOR_CACHE_LINE, size)!=0){
+            for (int v=0;v<w;v++){
+                free(workers[v].titles);
+            }
+            free(workers);
+            return NULL;
+        }
+        memset(memory, 0, size);
+        /* The counters come first, so the widest elements keep the rest
+         * aligned. */
+        SimulatorWorker* worker = &workers[w];
+        worker->titles = memory;
+        worker->top_three = worker->titles+n;
+        worker->constructors_titles = worker->top_three+n;
+        worker->race_keys = (double*)(worker->constructors_titles+t);
+        worker->keys = (SimulatorKey*)(worker->race_keys+n);
+        worker->points = (int*)(worker->keys+n);
+        worker->positions = worker->points+futures*n;
+        worker->teams_points = worker->positions+futures*n;
+        worker->teams_positions = worker->teams_points+futures*t;
+        worker->ranks = worker->teams_positions+futures*t;
+        worker->simulator = simulator;
+        worker->races = races;
+        worker->simulations = simulations;
+        worker->worker = w;
+        worker->workers = threads;
+        worker->seed = seed;
+    }
+    return workers;
+}
+
+/**
+ ***** Static Function : SimulatorWorkerRun *****
+ * Description: plays the chunks of simulations of a worker,
+ * SIMULATOR_FUTURES seasons at a time.
+ * @param worker - A pointer to a worker.
+ * @return - NULL.
+ */
+static void* SimulatorWorkerRun(void* worker_memory){
+    SimulatorWorker* worker = worker_memory;
+    assert(worker!=NULL);
+    for (long long chunk=worker->worker;
+         chunk*SIMULATOR_CHUNK<worker->simulations;chunk+=worker->workers){
+        SimulatorRandom random;
+        SimulatorRandomSeed(&random, worker->seed+(uint64_t)chunk);
+        long long end = (chunk+1)*SIMULATOR_CHUNK;
+        if (end>worker->simulations){
+            end = worker->simulations;
+        }
+        for (long long s=chunk*SIMULATOR_CHUNK;s<end;s+=SIMULATOR_FUTURES){
+            int futures = (end-s<SIMULATOR_FUTURES) ? (int)(end-s) :
+                                                      SIMULATOR_FUTURES;
+            SimulatorPlayFutures(worker, &random, futures);
+            SimulatorCountFutures(worker, futures);
+        }
+    }
+    return NULL;
+}
+
+/**
+ ***** Static Function : SimulatorPlayFutures *****
+ * Description: plays the remaining races of several seasons into the
+ * interleaved points and positions of a worker. Each race is sampled for
+ * every season and then scored in all of them by the points kernel. The
+ * positions are needed only for the last race, which breaks the ties.
+ * @param worker - A pointer to a worker.
+ * @param random - The random stream.
+ * @param futures - Number of seasons (at most SIMULATOR_FUTURES).
+ */
+static void SimulatorPlayFutures(SimulatorWorker* worker,
+                                 SimulatorRandom* random, int futures){
+    assert(worker!=NULL && random!=NULL && futures<=SIMULATOR_FUTURES);
+    Simulator simulator = worker->simulator;
+    int n = simulator->number_of_drivers;
+    for (int i=0;i<n;i++){
+        for (int f=0;f<futures;f++){
+            worker->points[(size_t)i*futures+f] = simulator->points[i];
+            worker->positions[(size_t)i*futures+f] =
+                    simulator->last_race_positions[i];
+        }
+    }
+    for (int race=0;race<worker->races;race++){
+        for (int f=0;f<futures;f++){
+            SimulatorSampleRace(worker, random, futures, f);
+        }
+        PointsAddRaceFutures(POINTS_BACKEND_AUTO, worker->points,
+                             worker->positions, n, futures);
+    }
+}
+
+/**
+ ***** Static Function : SimulatorSampleRace *****
+ * Description: samples the results of a race of one of the seasons a
+ * worker plays. A Plackett-Luce ranking is the order of independent
+ * exponential variables whose rates are the strengths.
+ * @param worker - A pointer to a worker.
+ * @param random - The random stream.
+ * @param futures - Number of seasons played together.
+ * @param future - The season of the race, whose positions it sets.
+ */
+static void SimulatorSampleRace(SimulatorWorker* worker,
+                                SimulatorRandom* random, int futures,
+                                int future){
+    assert(worker!=NULL && random!=NULL && future<futures);
+    Simulator simulator = worker->simulator;
+    int n = simulator->number_of_drivers;
+    double* keys = worker->race_keys;
+    int* positions = worker->positions+future;
+    for (int i=0;i<n;i++){
+        keys[i] = SimulatorRandomExponential(random)*
+                  simulator->inverse_strengths[i];
+    }
+    if (n>SIMULATOR_RANK_KERNEL_MAX){
+        for (int i=0;i<n;i++){
+            worker->keys[i].key = keys[i];
+            worker->keys[i].index = i;
+        }
+        qsort(worker->keys, (size_t)n, sizeof(*worker->keys),
+              CompareSimulatorKeys);
+        for (int p=0;p<n;p++){
+            positions[(size_t)worker->keys[p].index*futures] = p+1;
+        }
+        return;
+    }
+    /* The position of a driver is one more than the number of drivers with
+     * a smaller key (the lower index first on equal keys). Unlike a sort
+     * of random keys, counting them doesn't mispredict branches. */
+    for (int i=0;i<n;i++){
+        int position = 1;
+        for (int j=0;j<i;j++){
+            position += keys[j]<=keys[i];
+        }
+        for (int j=i+1;j<n;j++){
+            position += keys[j]<keys[i];
+        }
+        positions[(size_t)i*futures] = position;
+    }
+}
+
+/**
+ ***** Static Function : SimulatorCountFutures *****
+ * Description: counts the champions and top three drivers and the
+ * champion teams of played seasons. A team has the points of its drivers
+ * and, like in the season, the best last race position of its drivers,
+ * where an empty seat counts as position 0.
+ * @param worker - A pointer to a worker with played seasons.
+ * @param futures - Number of seasons.
+ */
+static void SimulatorCountFutures(SimulatorWorker* worker, int futures){
+    assert(worker!=NULL);
+    Simulator simulator = worker->simulator;
+    SimulatorCountLeaders(worker, worker->points, worker->positions,
+                          simulator->number_of_drivers, futures,
+                          worker->titles, worker->top_three);
+    for (int j=0;j<simulator->number_of_teams;j++){
+        int* team_points = worker->teams_points+(size_t)j*futures;
+        int* team_positions = worker->teams_positions+(size_t)j*futures;
+        for (int f=0;f<futures;f++){
+            team_points[f] = 0;
+            team_positions[f] = -1;
+        }
+        for (int seat=2*j;seat<2*j+2;seat++){
+            int driver = simulator->teams_drivers[seat];
+            if (driver<0){ // No position is better than an empty seat.
+                memset(team_positions, 0, sizeof(*team_positions)*futures);
+                continue;
+            }
+            const int* points = worker->points+(size_t)driver*futures;
+            const int* positions = worker->positions+(size_t)driver*futures;
+            for (int f=0;f<futures;f++){
+                team_points[f] += points[f];
+                if (team_positions[f]<0 || positions[f]<team_positions[f]){
+                    team_positions[f] = positions[f];
+                }
+            }
+        }
+    }
+    SimulatorCountLeaders(worker, worker->teams_points,
+                          worker->teams_positions, simulator->number_of_teams,
+                          futures, worker->constructors_titles, NULL);
+}
+
+/**
+ ***** Static Function : SimulatorCountLeaders *****
+ * Description: counts the leaders of the standings of played seasons.
+ * Small standings are ranked by the vector kernel, large ones by selecting
+ * the leaders of each season in one pass. Both order the standings like
+ * the season: by points, then by the last race position, then by index.
+ * @param worker - A pointer to a worker.
+ * @param points - The interleaved points of the drivers (or teams).
+ * @param positions - Their interleaved last race positions.
+ * @param count - Number of drivers (or teams).
+ * @param futures - Number of seasons.
+ * @param titles - titles[i] is incremented for every season i leads.
+ * @param top_three - If not NULL, top_three[i] is incremented for every
+ * season i finishes in the top three.
+ */
+static void SimulatorCountLeaders(SimulatorWorker* worker, const int* points,
+                                  const int* positions, int count,
+                                  int futures, long long* titles,
+                                  long long* top_three){
+    assert(worker!=NULL && points!=NULL && positions!=NULL &&
+           titles!=NULL);
+    if (count<=SIMULATOR_RANK_KERNEL_MAX){
+        PointsRankFutures(POINTS_BACKEND_AUTO, points, positions, count,
+                          futures, worker->ranks);
+        for (int i=0;i<count;i++){
+            const int* ranks = worker->ranks+(size_t)i*futures;
+            for (int f=0;f<futures;f++){
+                titles[i] += ranks[f]==1;
+                if (top_three!=NULL){
+                    top_three[i] += ranks[f]<=3;
+                }
+            }
+        }
+        return;
+    }
+    for (int f=0;f<futures;f++){
+        int top[3] = {-1, -1, -1};
+        for (int i=0;i<count;i++){
+            /* Inserts entry i into the top three, if it belongs there. */
+            int point = points[(size_t)i*futures+f];
+            int position = positions[(size_t)i*futures+f];
+            int place = 3;
+            while (place>0 && (top[place-1]<0 ||
+                   StandingsComesFirst(point, position, i,
+                           points[(size_t)top[place-1]*futures+f],
+                           positions[(size_t)top[place-1]*futures+f],
+                           top[place-1]))){
+                place--;
+            }
+            for (int k=2;k>place;k--){
+                top[k] = top[k-1];
+            }
+            if (place<3){
+                top[place] = i;
+            }
+        }
+        titles[top[0]]++;
+        for (int k=0;k<3 && top[k]>=0 && top_three!=NULL;k++){
+            top_three[top[k]]++;
+        }
+    }
+}
+
+/**
+ ***** Static function: CompareSimulatorKeys *****
+ * Description: qsort comparator of simulator keys, by increasing key.
+ * @param first - A pointer to a simulator key.
+ * @param second - A pointer to a simulator key.
+ * @return - Negative if 'first' should come first, positive otherwise.
+ */
+static int CompareSimulatorKeys(const void* first, const void* second){
+    const SimulatorKey* first_key = first;
+    const SimulatorKey* second_key = second;
+    if (first_key->key != second_key->key){
+        return (first_key->key < second_key->key) ? -1 : 1;
+    }
+    return (first_key->index < second_key->index) ? -1 : 1;
+}
+
+/**
+ ***** Static Function : StandingsComesFirst *****
+ * Description: the standings order of the season: more points first, then
+ * the better last race position, then the lower index.
+ * @return - True if the first driver (or team) comes before the second.
+ */
+static bool StandingsComesFirst(int first_points, int first_position,
+                                int first_index, int second_points,
+                                int second_position, int second_index){
+    if (first_points!=second_points){
+        return first_points>second_points;
+    }
+    if (first_position!=second_position){
+        return first_position<second_position;
+    }
+    return first_index<second_index;
+}
+
+/**
+ ***** Static Function : SimulatorRandomSeed *****
+ * Description: seeds a random stream. Streams of close seeds are unrelated.
+ * @param random - A random stream.
+ * @param seed - The seed.
+ */
+static void SimulatorRandomSeed(SimulatorRandom* random, uint64_t seed){
+    assert(random!=NULL);
+    uint64_t state = seed;
+    for (int i=0;i<4;i++){
+        random->state[i] = SplitMix64(&state);
+    }
+}
+
+/**
+ ***** Static Function : SimulatorRandomNext *****
+ * @param random - A random stream.
+ * @return - The next 64 random bits of the stream.
+ */
+static uint64_t SimulatorRandomNext(SimulatorRandom* random){
+    uint64_t* s = random->state;
+    uint64_t x = s[1]*5;
+    uint64_t result = ((x<<7)|(x>>57))*9;
+    uint64_t t = s[1]<<17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3]<<45)|(s[3]>>19);
+    return result;
+}
+
+/**
+ ***** Static Function : SimulatorRandomExponential *****
+ * @param random - A random stream.
+ * @return - An exponential random variable with rate 1.
+ */
+static double SimulatorRandomExponential(SimulatorRandom* random){
+    /* A uniform variable in (0,1], so the log is finite. */
+    double uniform = (double)((SimulatorRandomNext(random)>>11)+1)*
+                     (1.0/9007199254740992.0);
+    return -log(uniform);
+}
+
+/**
+ ***** Static Function : SplitMix64 *****
+ * @param state - The state of a splitmix64 generator.
+ * @return - The next output of the generator.
+ */
+static uint64_t SplitMix64(uint64_t* state){
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+    z = (z^(z>>27))*0x94D049BB133111EBULL;
+    return z^(z>>31);
+}
+/** End of static functions */
@@ -0,0 +1,31 @@
+/*
+ * simulator.h
+ */
+
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+#include <stdint.h>
+#include "season.h"
+
+typedef struct simulator* Simulator;
+
+typedef enum simulatorStatus {
+    SIMULATOR_OK,
+    SIMULATOR_MEMORY_ERROR,
+    SIMULATOR_NULL_PTR,
+    SIMULATOR_BAD_ARGUMENT} SimulatorStatus;
+
+Simulator SimulatorCreate(Season season, SimulatorStatus* status);
+void SimulatorDestroy(Simulator simulator);
+SimulatorStatus SimulatorSetDriverStrength(Simulator simulator, Driver driver,
+                                           double strength);
+SimulatorStatus SimulatorRun(Simulator simulator, int races,
+                             long long simulations, int threads,
+                             uint64_t seed);
+double SimulatorGetTitleProbability(Simulator simulator, Driver driver);
+double SimulatorGetTopThreeProbability(Simulator simulator, Driver driver);
+double SimulatorGetConstructorsTitleProbability(Simulator simulator,
+                                                Team team);
+
+#endif /* SIMULATOR_H_ */
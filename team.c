@@ -2,6 +2,7 @@
 #include <malloc.h>
 #include <string.h>
 #include <assert.h>
+#include <stdbool.h>
 #include "team.h"
 
 /** Declarations */
@@ -12,6 +13,7 @@ struct team{
         char* name;
         Driver first_driver;
         Driver second_driver;
+        bool owns_name; // False if the name belongs to someone else.
 };
 
 /**
@@ -40,16 +42,67 @@ Team TeamCreate(TeamStatus* status, char* name){
         return NULL;
     }
     strcpy(string,name);
+    Team team = TeamCreateNoCopy(status,string);
+    if(team == NULL){
+        free(string);
+        return NULL;
+    }
+    team->owns_name = true;
+    return team;
+}
+
+/**
+ ***** TeamCreateNoCopy *****
+ * Description: creates a new team which uses the given name without
+ * copying it. Used by the season, which keeps all the names in one buffer.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @param name - name of the new team. It must outlive the team and is not
+ * freed by TeamDestroy.
+ * @return Pointer to the new team.
+ * Note: The team is created without drivers (first and second drivers are
+ * set to be NULL).
+ */
+Team TeamCreateNoCopy(TeamStatus* status, char* name){
+    if(name==NULL){
+        if (status!=NULL){
+            *status = TEAM_NULL_PTR;
+        }
+        return NULL;
+    }
     Team team = malloc(sizeof(*team));
     if(team == NULL){ // Team memory allocation failed.
         if (status!=NULL){
             *status = TEAM_MEMORY_ERROR;
         }
-        free(string);
+        return NULL;
+    }
+    return TeamCreateAt(team,status,name);
+}
+
+/**
+ ***** TeamCreateAt *****
+ * Description: creates a new team in the given memory, without copying its
+ * name. Used by the season, which keeps all its teams in one block. Such a
+ * team must not be destroyed with TeamDestroy, it goes away with its
+ * memory.
+ * @param memory - At least TeamGetSize() bytes, aligned for a pointer.
+ * @param status - Success/failure of the function (if fails - with cause).
+ * @param name - name of the new team. It must outlive the team.
+ * @return Pointer to the new team.
+ * Note: The team is created without drivers (first and second drivers are
+ * set to be NULL).
+ */
+Team TeamCreateAt(void* memory, TeamStatus* status, char* name){
+    if(memory==NULL || name==NULL){
+        if (status!=NULL){
+            *status = TEAM_NULL_PTR;
+        }
         return NULL;
     }
     /* If we got here we can create the team. */
-    team->name = string;
+    Team team = memory;
+    team->name = name;
+    team->owns_name = false;
     team->first_driver = NULL;
     team->second_driver = NULL;
     if (status!=NULL){
@@ -58,6 +111,14 @@ Team TeamCreate(TeamStatus* status, char* name){
     return team;
 }
 
+/**
+ ***** Function: TeamGetSize *****
+ * @return - The number of bytes TeamCreateAt needs for a team.
+ */
+size_t TeamGetSize(void){
+    return sizeof(struct team);
+}
+
 /**
  ***** Function: TeamDestroy *****
  * Description: freeing all allocated memory of 'team' including
@@ -68,7 +129,9 @@ void TeamDestroy(Team team){
     if(team!=NULL){
         DriverDestroy(team->first_driver);
         DriverDestroy(team->second_driver);
-        free(team->name);
+        if (team->owns_name){
+            free(team->name);
+        }
         free(team);
     }
 }
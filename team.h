@@ -7,6 +7,8 @@
 
 typedef struct team * Team;
 
+#include <stddef.h>
+
 #include"driver.h"
 
 typedef enum teamStatus {
@@ -18,6 +20,9 @@ typedef enum driverNumber {FIRST_DRIVER, SECOND_DRIVER} DriverNumber;
 
 
 Team TeamCreate(TeamStatus* status, char* name);
+Team TeamCreateNoCopy(TeamStatus* status, char* name);
+Team TeamCreateAt(void* memory, TeamStatus* status, char* name);
+size_t TeamGetSize(void);
 void TeamDestroy(Team team);
 TeamStatus TeamAddDriver(Team team, Driver driver);
 const char * TeamGetName(Team  team);